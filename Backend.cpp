@@ -0,0 +1,447 @@
+#include "Backend.hpp"
+#include "Error.hpp"
+#include <GL/glew.h>
+#include <cstddef>
+
+namespace Vicetrice
+{
+	namespace
+	{
+		Backend* s_Backend = nullptr;
+
+		// Offsets into the bound buffer are passed to GL as pointers
+		inline const void* BufferOffset(unsigned int offset)
+		{
+			return reinterpret_cast<const void*>(static_cast<size_t>(offset));
+		}
+	}
+
+	Backend& Backend::Get()
+	{
+		static OpenGLBackend gl;
+		return s_Backend != nullptr ? *s_Backend : gl;
+	}
+
+	void Backend::Set(Backend* backend)
+	{
+		s_Backend = backend;
+	}
+
+
+	unsigned int OpenGLBackend::GenBuffer()
+	{
+		unsigned int buffer;
+		GLCall(glGenBuffers(1, &buffer));
+		return buffer;
+	}
+
+	void OpenGLBackend::DeleteBuffer(unsigned int buffer)
+	{
+		GLCall(glDeleteBuffers(1, &buffer));
+	}
+
+	void OpenGLBackend::BindBuffer(unsigned int target, unsigned int buffer)
+	{
+		GLCall(glBindBuffer(target, buffer));
+	}
+
+	void OpenGLBackend::BufferData(unsigned int target, unsigned int size, const void* data, unsigned int usage)
+	{
+		GLCall(glBufferData(target, size, data, usage));
+	}
+
+	void OpenGLBackend::BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data)
+	{
+		GLCall(glBufferSubData(target, offset, size, data));
+	}
+
+	void OpenGLBackend::BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size)
+	{
+		GLCall(glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size)));
+	}
+
+
+	bool OpenGLBackend::BufferStorage(unsigned int target, unsigned int size, unsigned int flags)
+	{
+		if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage)
+			return false;
+
+		GLCall(glBufferStorage(target, size, nullptr, flags));
+		return true;
+	}
+
+	void* OpenGLBackend::MapBufferRange(unsigned int target, unsigned int offset, unsigned int size, unsigned int access)
+	{
+		void* data;
+		GLCall(data = glMapBufferRange(target, offset, size, access));
+		return data;
+	}
+
+	void OpenGLBackend::FlushMappedBufferRange(unsigned int target, unsigned int offset, unsigned int size)
+	{
+		GLCall(glFlushMappedBufferRange(target, offset, size));
+	}
+
+	void OpenGLBackend::UnmapBuffer(unsigned int target)
+	{
+		GLCall(glUnmapBuffer(target));
+	}
+
+	void* OpenGLBackend::FenceSync()
+	{
+		GLsync fence;
+		GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+		return fence;
+	}
+
+	void OpenGLBackend::ClientWaitSync(void* fence)
+	{
+		GLsync sync = static_cast<GLsync>(fence);
+		GLenum status = GL_TIMEOUT_EXPIRED;
+		while (status == GL_TIMEOUT_EXPIRED)
+		{
+			GLCall(status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+		}
+	}
+
+	void OpenGLBackend::DeleteSync(void* fence)
+	{
+		GLCall(glDeleteSync(static_cast<GLsync>(fence)));
+	}
+
+
+	unsigned int OpenGLBackend::GenVertexArray()
+	{
+		unsigned int array;
+		GLCall(glGenVertexArrays(1, &array));
+		return array;
+	}
+
+	void OpenGLBackend::DeleteVertexArray(unsigned int array)
+	{
+		GLCall(glDeleteVertexArrays(1, &array));
+	}
+
+	void OpenGLBackend::BindVertexArray(unsigned int array)
+	{
+		GLCall(glBindVertexArray(array));
+	}
+
+	void OpenGLBackend::EnableVertexAttribArray(unsigned int index)
+	{
+		GLCall(glEnableVertexAttribArray(index));
+	}
+
+	void OpenGLBackend::VertexAttribPointer(unsigned int index, int count, unsigned int type, bool normalized, int stride, unsigned int offset)
+	{
+		GLCall(glVertexAttribPointer(index, count, type, normalized ? GL_TRUE : GL_FALSE, stride, BufferOffset(offset)));
+	}
+
+	void OpenGLBackend::VertexAttribIPointer(unsigned int index, int count, unsigned int type, int stride, unsigned int offset)
+	{
+		GLCall(glVertexAttribIPointer(index, count, type, stride, BufferOffset(offset)));
+	}
+
+	void OpenGLBackend::VertexAttribDivisor(unsigned int index, unsigned int divisor)
+	{
+		GLCall(glVertexAttribDivisor(index, divisor));
+	}
+
+
+	unsigned int OpenGLBackend::CreateShader(unsigned int type)
+	{
+		unsigned int shader;
+		GLCall(shader = glCreateShader(type));
+		return shader;
+	}
+
+	void OpenGLBackend::ShaderSource(unsigned int shader, const char* source)
+	{
+		GLCall(glShaderSource(shader, 1, &source, nullptr));
+	}
+
+	void OpenGLBackend::CompileShader(unsigned int shader)
+	{
+		GLCall(glCompileShader(shader));
+	}
+
+	int OpenGLBackend::GetShaderiv(unsigned int shader, unsigned int pname)
+	{
+		int value;
+		GLCall(glGetShaderiv(shader, pname, &value));
+		return value;
+	}
+
+	void OpenGLBackend::GetShaderInfoLog(unsigned int shader, int size, char* log)
+	{
+		GLCall(glGetShaderInfoLog(shader, size, nullptr, log));
+	}
+
+	void OpenGLBackend::DeleteShader(unsigned int shader)
+	{
+		GLCall(glDeleteShader(shader));
+	}
+
+	unsigned int OpenGLBackend::CreateProgram()
+	{
+		unsigned int program;
+		GLCall(program = glCreateProgram());
+		return program;
+	}
+
+	void OpenGLBackend::AttachShader(unsigned int program, unsigned int shader)
+	{
+		GLCall(glAttachShader(program, shader));
+	}
+
+	void OpenGLBackend::LinkProgram(unsigned int program)
+	{
+		GLCall(glLinkProgram(program));
+	}
+
+	void OpenGLBackend::ValidateProgram(unsigned int program)
+	{
+		GLCall(glValidateProgram(program));
+	}
+
+	int OpenGLBackend::GetProgramiv(unsigned int program, unsigned int pname)
+	{
+		int value;
+		GLCall(glGetProgramiv(program, pname, &value));
+		return value;
+	}
+
+	void OpenGLBackend::GetProgramInfoLog(unsigned int program, int size, char* log)
+	{
+		GLCall(glGetProgramInfoLog(program, size, nullptr, log));
+	}
+
+	void OpenGLBackend::DeleteProgram(unsigned int program)
+	{
+		GLCall(glDeleteProgram(program));
+	}
+
+	void OpenGLBackend::UseProgram(unsigned int program)
+	{
+		GLCall(glUseProgram(program));
+	}
+
+
+	static bool HasProgramBinary()
+	{
+		return GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary;
+	}
+
+	void OpenGLBackend::ProgramBinaryRetrievable(unsigned int program)
+	{
+		if (HasProgramBinary())
+		{
+			GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+		}
+	}
+
+	bool OpenGLBackend::GetProgramBinary(unsigned int program, std::vector<char>& binary, unsigned int& format)
+	{
+		if (!HasProgramBinary())
+			return false;
+
+		int length = 0;
+		GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+		if (length <= 0)
+			return false;
+
+		binary.resize(static_cast<size_t>(length));
+		GLenum BinaryFormat = 0;
+		GLCall(glGetProgramBinary(program, length, &length, &BinaryFormat, binary.data()));
+		binary.resize(static_cast<size_t>(length));
+		format = BinaryFormat;
+
+		return length > 0;
+	}
+
+	bool OpenGLBackend::ProgramBinary(unsigned int program, unsigned int format, const void* binary, int size)
+	{
+		if (!HasProgramBinary())
+			return false;
+
+		// A binary from another driver or GPU is rejected with a link failure, not an error
+		GLCall(glProgramBinary(program, format, binary, size));
+		int linked = GL_FALSE;
+		GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+
+		return linked == GL_TRUE;
+	}
+
+
+	unsigned int OpenGLBackend::GenFramebuffer()
+	{
+		unsigned int framebuffer;
+		GLCall(glGenFramebuffers(1, &framebuffer));
+		return framebuffer;
+	}
+
+	void OpenGLBackend::DeleteFramebuffer(unsigned int framebuffer)
+	{
+		GLCall(glDeleteFramebuffers(1, &framebuffer));
+	}
+
+	void OpenGLBackend::BindFramebuffer(unsigned int target, unsigned int framebuffer)
+	{
+		GLCall(glBindFramebuffer(target, framebuffer));
+	}
+
+	unsigned int OpenGLBackend::GenRenderbuffer()
+	{
+		unsigned int renderbuffer;
+		GLCall(glGenRenderbuffers(1, &renderbuffer));
+		return renderbuffer;
+	}
+
+	void OpenGLBackend::DeleteRenderbuffer(unsigned int renderbuffer)
+	{
+		GLCall(glDeleteRenderbuffers(1, &renderbuffer));
+	}
+
+	void OpenGLBackend::RenderbufferStorage(unsigned int renderbuffer, unsigned int format, int width, int height)
+	{
+		GLCall(glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer));
+		GLCall(glRenderbufferStorage(GL_RENDERBUFFER, format, width, height));
+	}
+
+	void OpenGLBackend::FramebufferRenderbuffer(unsigned int target, unsigned int attachment, unsigned int renderbuffer)
+	{
+		GLCall(glFramebufferRenderbuffer(target, attachment, GL_RENDERBUFFER, renderbuffer));
+	}
+
+	void OpenGLBackend::BlitFramebuffer(int x, int y, int width, int height, unsigned int mask)
+	{
+		GLCall(glBlitFramebuffer(x, y, x + width, y + height, x, y, x + width, y + height, mask, GL_NEAREST));
+	}
+
+
+	unsigned int OpenGLBackend::GenTexture()
+	{
+		unsigned int texture;
+		GLCall(glGenTextures(1, &texture));
+		return texture;
+	}
+
+	void OpenGLBackend::DeleteTexture(unsigned int texture)
+	{
+		GLCall(glDeleteTextures(1, &texture));
+	}
+
+	void OpenGLBackend::ActiveTexture(unsigned int unit)
+	{
+		GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+	}
+
+	void OpenGLBackend::BindTexture(unsigned int target, unsigned int texture)
+	{
+		GLCall(glBindTexture(target, texture));
+	}
+
+	void OpenGLBackend::TexImage2D(unsigned int target, unsigned int InternalFormat, int width, int height, unsigned int format, unsigned int type, const void* data)
+	{
+		GLCall(glTexImage2D(target, 0, static_cast<GLint>(InternalFormat), width, height, 0, format, type, data));
+	}
+
+	void OpenGLBackend::TexSubImage2D(unsigned int target, int x, int y, int width, int height, unsigned int format, unsigned int type, const void* data)
+	{
+		GLCall(glTexSubImage2D(target, 0, x, y, width, height, format, type, data));
+	}
+
+	void OpenGLBackend::TexParameteri(unsigned int target, unsigned int name, int value)
+	{
+		GLCall(glTexParameteri(target, name, value));
+	}
+
+
+	int OpenGLBackend::GetUniformLocation(unsigned int program, const char* name)
+	{
+		int location;
+		GLCall(location = glGetUniformLocation(program, name));
+		return location;
+	}
+
+	void OpenGLBackend::Uniform1i(int location, int v0)
+	{
+		GLCall(glUniform1i(location, v0));
+	}
+
+	void OpenGLBackend::Uniform1f(int location, float v0)
+	{
+		GLCall(glUniform1f(location, v0));
+	}
+
+	void OpenGLBackend::Uniform4f(int location, float v0, float v1, float v2, float v3)
+	{
+		GLCall(glUniform4f(location, v0, v1, v2, v3));
+	}
+
+	void OpenGLBackend::UniformMatrix4fv(int location, const float* value)
+	{
+		GLCall(glUniformMatrix4fv(location, 1, GL_FALSE, value));
+	}
+
+	unsigned int OpenGLBackend::GetUniformBlockIndex(unsigned int program, const char* name)
+	{
+		unsigned int block;
+		GLCall(block = glGetUniformBlockIndex(program, name));
+		return block;
+	}
+
+	void OpenGLBackend::UniformBlockBinding(unsigned int program, unsigned int block, unsigned int binding)
+	{
+		GLCall(glUniformBlockBinding(program, block, binding));
+	}
+
+	int OpenGLBackend::UniformBufferOffsetAlignment()
+	{
+		int alignment = 0;
+		GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+		return alignment;
+	}
+
+
+	void OpenGLBackend::DrawElements(unsigned int mode, int count, unsigned int type, unsigned int offset)
+	{
+		GLCall(glDrawElements(mode, count, type, BufferOffset(offset)));
+	}
+
+	void OpenGLBackend::DrawElementsInstanced(unsigned int mode, int count, unsigned int type, unsigned int offset, int instances)
+	{
+		GLCall(glDrawElementsInstanced(mode, count, type, BufferOffset(offset), instances));
+	}
+
+	void OpenGLBackend::Clear(unsigned int mask)
+	{
+		GLCall(glClear(mask));
+	}
+
+	void OpenGLBackend::Viewport(int x, int y, int width, int height)
+	{
+		GLCall(glViewport(x, y, width, height));
+	}
+
+	void OpenGLBackend::Enable(unsigned int capability)
+	{
+		GLCall(glEnable(capability));
+	}
+
+	void OpenGLBackend::Disable(unsigned int capability)
+	{
+		GLCall(glDisable(capability));
+	}
+
+	void OpenGLBackend::Scissor(int x, int y, int width, int height)
+	{
+		GLCall(glScissor(x, y, width, height));
+	}
+
+	void OpenGLBackend::BlendFunc(unsigned int source, unsigned int destination)
+	{
+		GLCall(glBlendFunc(source, destination));
+	}
+
+} // namespace Vicetrice
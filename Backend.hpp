@@ -0,0 +1,208 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Every GL call made by the toolkit goes through the current backend.
+	 *
+	 * OpenGLBackend forwards to the driver, RecordingBackend captures the command stream so the
+	 * toolkit can run and be measured without a GPU. Object names are plain unsigned ints, the
+	 * enums are the GL ones.
+	 */
+	class Backend
+	{
+	public:
+
+		virtual ~Backend() = default;
+
+		/**
+		 * @brief Returns the backend the toolkit is drawing with, OpenGLBackend unless Set was called.
+		 */
+		static Backend& Get();
+
+		/**
+		 * @brief Makes backend the current one, nullptr goes back to OpenGLBackend.
+		 *
+		 * Objects must be destroyed by the backend that created them.
+		 */
+		static void Set(Backend* backend);
+
+		//Buffers
+		virtual unsigned int GenBuffer() = 0;
+		virtual void DeleteBuffer(unsigned int buffer) = 0;
+		virtual void BindBuffer(unsigned int target, unsigned int buffer) = 0;
+		virtual void BufferData(unsigned int target, unsigned int size, const void* data, unsigned int usage) = 0;
+		virtual void BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data) = 0;
+		virtual void BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size) = 0;
+
+		//Streaming, a backend without the feature returns false or nullptr and the caller falls back to BufferSubData
+		virtual bool BufferStorage(unsigned int target, unsigned int size, unsigned int flags) = 0;
+		virtual void* MapBufferRange(unsigned int target, unsigned int offset, unsigned int size, unsigned int access) = 0;
+		virtual void FlushMappedBufferRange(unsigned int target, unsigned int offset, unsigned int size) = 0;
+		virtual void UnmapBuffer(unsigned int target) = 0;
+		virtual void* FenceSync() = 0;
+		virtual void ClientWaitSync(void* fence) = 0;
+		virtual void DeleteSync(void* fence) = 0;
+
+		//Vertex arrays
+		virtual unsigned int GenVertexArray() = 0;
+		virtual void DeleteVertexArray(unsigned int array) = 0;
+		virtual void BindVertexArray(unsigned int array) = 0;
+		virtual void EnableVertexAttribArray(unsigned int index) = 0;
+		virtual void VertexAttribPointer(unsigned int index, int count, unsigned int type, bool normalized, int stride, unsigned int offset) = 0;
+		virtual void VertexAttribIPointer(unsigned int index, int count, unsigned int type, int stride, unsigned int offset) = 0;
+		virtual void VertexAttribDivisor(unsigned int index, unsigned int divisor) = 0;
+
+		//Shaders
+		virtual unsigned int CreateShader(unsigned int type) = 0;
+		virtual void ShaderSource(unsigned int shader, const char* source) = 0;
+		virtual void CompileShader(unsigned int shader) = 0;
+		virtual int GetShaderiv(unsigned int shader, unsigned int pname) = 0;
+		virtual void GetShaderInfoLog(unsigned int shader, int size, char* log) = 0;
+		virtual void DeleteShader(unsigned int shader) = 0;
+		virtual unsigned int CreateProgram() = 0;
+		virtual void AttachShader(unsigned int program, unsigned int shader) = 0;
+		virtual void LinkProgram(unsigned int program) = 0;
+		virtual void ValidateProgram(unsigned int program) = 0;
+		virtual int GetProgramiv(unsigned int program, unsigned int pname) = 0;
+		virtual void GetProgramInfoLog(unsigned int program, int size, char* log) = 0;
+		virtual void DeleteProgram(unsigned int program) = 0;
+		virtual void UseProgram(unsigned int program) = 0;
+
+		//Program binaries, a backend without them returns false and the program is compiled from source
+		virtual void ProgramBinaryRetrievable(unsigned int program) = 0;
+		virtual bool GetProgramBinary(unsigned int program, std::vector<char>& binary, unsigned int& format) = 0;
+		virtual bool ProgramBinary(unsigned int program, unsigned int format, const void* binary, int size) = 0;
+
+		//Framebuffers
+		virtual unsigned int GenFramebuffer() = 0;
+		virtual void DeleteFramebuffer(unsigned int framebuffer) = 0;
+		virtual void BindFramebuffer(unsigned int target, unsigned int framebuffer) = 0;
+		virtual unsigned int GenRenderbuffer() = 0;
+		virtual void DeleteRenderbuffer(unsigned int renderbuffer) = 0;
+		virtual void RenderbufferStorage(unsigned int renderbuffer, unsigned int format, int width, int height) = 0;
+		virtual void FramebufferRenderbuffer(unsigned int target, unsigned int attachment, unsigned int renderbuffer) = 0;
+		virtual void BlitFramebuffer(int x, int y, int width, int height, unsigned int mask) = 0;
+
+		//Textures, pixels are read with the default unpack state: rows aligned to 4 bytes
+		virtual unsigned int GenTexture() = 0;
+		virtual void DeleteTexture(unsigned int texture) = 0;
+		virtual void ActiveTexture(unsigned int unit) = 0;
+		virtual void BindTexture(unsigned int target, unsigned int texture) = 0;
+		virtual void TexImage2D(unsigned int target, unsigned int InternalFormat, int width, int height, unsigned int format, unsigned int type, const void* data) = 0;
+		virtual void TexSubImage2D(unsigned int target, int x, int y, int width, int height, unsigned int format, unsigned int type, const void* data) = 0;
+		virtual void TexParameteri(unsigned int target, unsigned int name, int value) = 0;
+
+		//Uniforms
+		virtual int GetUniformLocation(unsigned int program, const char* name) = 0;
+		virtual void Uniform1i(int location, int v0) = 0;
+		virtual void Uniform1f(int location, float v0) = 0;
+		virtual void Uniform4f(int location, float v0, float v1, float v2, float v3) = 0;
+		virtual void UniformMatrix4fv(int location, const float* value) = 0;
+		virtual unsigned int GetUniformBlockIndex(unsigned int program, const char* name) = 0;
+		virtual void UniformBlockBinding(unsigned int program, unsigned int block, unsigned int binding) = 0;
+		virtual int UniformBufferOffsetAlignment() = 0;
+
+		//Drawing
+		virtual void DrawElements(unsigned int mode, int count, unsigned int type, unsigned int offset) = 0;
+		virtual void DrawElementsInstanced(unsigned int mode, int count, unsigned int type, unsigned int offset, int instances) = 0;
+		virtual void Clear(unsigned int mask) = 0;
+		virtual void Viewport(int x, int y, int width, int height) = 0;
+		virtual void Enable(unsigned int capability) = 0;
+		virtual void Disable(unsigned int capability) = 0;
+		virtual void Scissor(int x, int y, int width, int height) = 0;
+		virtual void BlendFunc(unsigned int source, unsigned int destination) = 0;
+
+	}; // class Backend
+
+
+	/**
+	 * @brief Backend that calls the driver through GLEW, checking every call with GLCall.
+	 */
+	class OpenGLBackend : public Backend
+	{
+	public:
+
+		unsigned int GenBuffer() override;
+		void DeleteBuffer(unsigned int buffer) override;
+		void BindBuffer(unsigned int target, unsigned int buffer) override;
+		void BufferData(unsigned int target, unsigned int size, const void* data, unsigned int usage) override;
+		void BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data) override;
+		void BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size) override;
+
+		bool BufferStorage(unsigned int target, unsigned int size, unsigned int flags) override;
+		void* MapBufferRange(unsigned int target, unsigned int offset, unsigned int size, unsigned int access) override;
+		void FlushMappedBufferRange(unsigned int target, unsigned int offset, unsigned int size) override;
+		void UnmapBuffer(unsigned int target) override;
+		void* FenceSync() override;
+		void ClientWaitSync(void* fence) override;
+		void DeleteSync(void* fence) override;
+
+		unsigned int GenVertexArray() override;
+		void DeleteVertexArray(unsigned int array) override;
+		void BindVertexArray(unsigned int array) override;
+		void EnableVertexAttribArray(unsigned int index) override;
+		void VertexAttribPointer(unsigned int index, int count, unsigned int type, bool normalized, int stride, unsigned int offset) override;
+		void VertexAttribIPointer(unsigned int index, int count, unsigned int type, int stride, unsigned int offset) override;
+		void VertexAttribDivisor(unsigned int index, unsigned int divisor) override;
+
+		unsigned int CreateShader(unsigned int type) override;
+		void ShaderSource(unsigned int shader, const char* source) override;
+		void CompileShader(unsigned int shader) override;
+		int GetShaderiv(unsigned int shader, unsigned int pname) override;
+		void GetShaderInfoLog(unsigned int shader, int size, char* log) override;
+		void DeleteShader(unsigned int shader) override;
+		unsigned int CreateProgram() override;
+		void AttachShader(unsigned int program, unsigned int shader) override;
+		void LinkProgram(unsigned int program) override;
+		void ValidateProgram(unsigned int program) override;
+		int GetProgramiv(unsigned int program, unsigned int pname) override;
+		void GetProgramInfoLog(unsigned int program, int size, char* log) override;
+		void DeleteProgram(unsigned int program) override;
+		void UseProgram(unsigned int program) override;
+
+		void ProgramBinaryRetrievable(unsigned int program) override;
+		bool GetProgramBinary(unsigned int program, std::vector<char>& binary, unsigned int& format) override;
+		bool ProgramBinary(unsigned int program, unsigned int format, const void* binary, int size) override;
+
+		unsigned int GenFramebuffer() override;
+		void DeleteFramebuffer(unsigned int framebuffer) override;
+		void BindFramebuffer(unsigned int target, unsigned int framebuffer) override;
+		unsigned int GenRenderbuffer() override;
+		void DeleteRenderbuffer(unsigned int renderbuffer) override;
+		void RenderbufferStorage(unsigned int renderbuffer, unsigned int format, int width, int height) override;
+		void FramebufferRenderbuffer(unsigned int target, unsigned int attachment, unsigned int renderbuffer) override;
+		void BlitFramebuffer(int x, int y, int width, int height, unsigned int mask) override;
+
+		unsigned int GenTexture() override;
+		void DeleteTexture(unsigned int texture) override;
+		void ActiveTexture(unsigned int unit) override;
+		void BindTexture(unsigned int target, unsigned int texture) override;
+		void TexImage2D(unsigned int target, unsigned int InternalFormat, int width, int height, unsigned int format, unsigned int type, const void* data) override;
+		void TexSubImage2D(unsigned int target, int x, int y, int width, int height, unsigned int format, unsigned int type, const void* data) override;
+		void TexParameteri(unsigned int target, unsigned int name, int value) override;
+
+		int GetUniformLocation(unsigned int program, const char* name) override;
+		void Uniform1i(int location, int v0) override;
+		void Uniform1f(int location, float v0) override;
+		void Uniform4f(int location, float v0, float v1, float v2, float v3) override;
+		void UniformMatrix4fv(int location, const float* value) override;
+		unsigned int GetUniformBlockIndex(unsigned int program, const char* name) override;
+		void UniformBlockBinding(unsigned int program, unsigned int block, unsigned int binding) override;
+		int UniformBufferOffsetAlignment() override;
+
+		void DrawElements(unsigned int mode, int count, unsigned int type, unsigned int offset) override;
+		void DrawElementsInstanced(unsigned int mode, int count, unsigned int type, unsigned int offset, int instances) override;
+		void Clear(unsigned int mask) override;
+		void Viewport(int x, int y, int width, int height) override;
+		void Enable(unsigned int capability) override;
+		void Disable(unsigned int capability) override;
+		void Scissor(int x, int y, int width, int height) override;
+		void BlendFunc(unsigned int source, unsigned int destination) override;
+
+	}; // class OpenGLBackend
+
+} // namespace Vicetrice
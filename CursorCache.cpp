@@ -0,0 +1,55 @@
+#include "CursorCache.hpp"
+
+namespace Vicetrice
+{
+	std::unordered_map<int, GLFWcursor*> CursorCache::s_cursors;
+	std::unordered_map<GLFWwindow*, int> CursorCache::s_current;
+	unsigned long long CursorCache::s_created = 0;
+	unsigned long long CursorCache::s_changes = 0;
+
+	void CursorCache::Set(GLFWwindow* context, int shape)
+	{
+		if (context == nullptr)
+			return;
+
+		// A context not seen yet shows the default cursor
+		auto current = s_current.emplace(context, 0).first;
+		if (current->second == shape)
+			return;
+
+		GLFWcursor* cursor = NULL;
+		if (shape != 0)
+		{
+			auto it = s_cursors.find(shape);
+			if (it == s_cursors.end())
+			{
+				it = s_cursors.emplace(shape, glfwCreateStandardCursor(shape)).first;
+				++s_created;
+			}
+			cursor = it->second;
+		}
+
+		glfwSetCursor(context, cursor);
+		current->second = shape;
+		++s_changes;
+	}
+
+	int CursorCache::Current(GLFWwindow* context)
+	{
+		auto it = s_current.find(context);
+		return it != s_current.end() ? it->second : 0;
+	}
+
+	void CursorCache::Clear()
+	{
+		for (auto& entry : s_cursors)
+		{
+			if (entry.second != NULL)
+				glfwDestroyCursor(entry.second);
+		}
+
+		s_cursors.clear();
+		s_current.clear();
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <unordered_map>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Standard cursors shared by every window and the cursor each context shows.
+	 *
+	 * Each cursor shape is created once, on its first use, and kept until Clear. Setting the cursor
+	 * a context already shows does nothing, so a mouse moving along a border of a window reaches
+	 * the platform only when the shape changes.
+	 */
+	class CursorCache
+	{
+	public:
+
+		/**
+		 * @brief Shows a standard cursor on a context.
+		 *
+		 * @param context Pointer to the GLFW window context, nothing is done when it is null (headless runs).
+		 * @param shape GLFW standard cursor shape, 0 restores the default cursor. A shape the platform lacks shows the default cursor.
+		 */
+		static void Set(GLFWwindow* context, int shape);
+
+		/**
+		 * @brief Shape shown on a context by the last Set, 0 for the default cursor.
+		 */
+		static int Current(GLFWwindow* context);
+
+		/**
+		 * @brief Destroys the cursors and forgets the contexts, call it before glfwTerminate.
+		 */
+		static void Clear();
+
+		/**
+		 * @brief Cursors created since the start, one per shape used.
+		 */
+		inline static unsigned long long Created() { return s_created; }
+
+		/**
+		 * @brief Times glfwSetCursor was called since the start.
+		 */
+		inline static unsigned long long Changes() { return s_changes; }
+
+	private:
+		static std::unordered_map<int, GLFWcursor*> s_cursors; /// By shape, null if the platform could not create it.
+		static std::unordered_map<GLFWwindow*, int> s_current; /// Shape shown by each context.
+		static unsigned long long s_created;
+		static unsigned long long s_changes;
+
+	}; // class CursorCache
+
+} // namespace Vicetrice
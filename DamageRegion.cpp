@@ -0,0 +1,100 @@
+#include "DamageRegion.hpp"
+#include <algorithm>
+
+namespace Vicetrice
+{
+	DamageRegion::DamageRegion()
+		: m_rects{},
+		m_width{ 0 },
+		m_height{ 0 }
+	{
+		m_rects.reserve(MaxRects + 1);
+	}
+
+	void DamageRegion::SetBounds(int width, int height)
+	{
+		m_width = width;
+		m_height = height;
+
+		std::vector<DamageRect> rects;
+		rects.swap(m_rects);
+		for (const DamageRect& rect : rects)
+			Add(rect.x, rect.y, rect.width, rect.height);
+	}
+
+	void DamageRegion::Add(int x, int y, int width, int height)
+	{
+		int x0 = std::max(x, 0);
+		int y0 = std::max(y, 0);
+		int x1 = std::min(x + width, m_width);
+		int y1 = std::min(y + height, m_height);
+
+		if (x0 >= x1 || y0 >= y1)
+			return;
+
+		// Merging can make the bounds reach rectangles checked before, so start over after each merge
+		bool merged = true;
+		while (merged)
+		{
+			merged = false;
+			for (std::size_t i = 0; i < m_rects.size(); i++)
+			{
+				const DamageRect& rect = m_rects[i];
+				if (rect.x > x1 || rect.x + rect.width < x0 || rect.y > y1 || rect.y + rect.height < y0)
+					continue;
+
+				x0 = std::min(x0, rect.x);
+				y0 = std::min(y0, rect.y);
+				x1 = std::max(x1, rect.x + rect.width);
+				y1 = std::max(y1, rect.y + rect.height);
+
+				m_rects[i] = m_rects.back();
+				m_rects.pop_back();
+				merged = true;
+				break;
+			}
+		}
+
+		m_rects.push_back({ x0, y0, x1 - x0, y1 - y0 });
+
+		if (m_rects.size() > MaxRects)
+		{
+			for (const DamageRect& rect : m_rects)
+			{
+				x0 = std::min(x0, rect.x);
+				y0 = std::min(y0, rect.y);
+				x1 = std::max(x1, rect.x + rect.width);
+				y1 = std::max(y1, rect.y + rect.height);
+			}
+
+			m_rects.clear();
+			m_rects.push_back({ x0, y0, x1 - x0, y1 - y0 });
+		}
+	}
+
+	void DamageRegion::AddAll()
+	{
+		m_rects.clear();
+		if (m_width > 0 && m_height > 0)
+			m_rects.push_back({ 0, 0, m_width, m_height });
+	}
+
+	void DamageRegion::Clear()
+	{
+		m_rects.clear();
+	}
+
+	bool DamageRegion::Full() const
+	{
+		return m_rects.size() == 1 && m_rects[0].width == m_width && m_rects[0].height == m_height;
+	}
+
+	long long DamageRegion::Area() const
+	{
+		long long area = 0;
+		for (const DamageRect& rect : m_rects)
+			area += static_cast<long long>(rect.width) * rect.height;
+		return area;
+	}
+
+} // namespace Vicetrice
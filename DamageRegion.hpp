@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Rectangle of the framebuffer in pixels, origin at the bottom left like glScissor.
+	 */
+	struct DamageRect
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	/**
+	 * @brief Parts of the framebuffer that changed since the last frame was presented.
+	 *
+	 * Rectangles that overlap or touch are merged into their bounds, so the ones kept never overlap.
+	 * Past MaxRects everything is merged into one, redrawing the region takes at most MaxRects scissored passes.
+	 */
+	class DamageRegion
+	{
+	public:
+
+		static const unsigned int MaxRects = 4;
+
+		DamageRegion();
+
+		/**
+		 * @brief Sets the size of the framebuffer, rectangles are clipped to it.
+		 */
+		void SetBounds(int width, int height);
+
+		/**
+		 * @brief Adds a rectangle, nothing is added if it is empty once clipped.
+		 */
+		void Add(int x, int y, int width, int height);
+
+		/**
+		 * @brief Damages the whole framebuffer.
+		 */
+		void AddAll();
+
+		void Clear();
+
+		inline bool Empty() const { return m_rects.empty(); }
+
+		inline const std::vector<DamageRect>& Rects() const { return m_rects; }
+
+		/**
+		 * @brief True if the region covers the whole framebuffer.
+		 */
+		bool Full() const;
+
+		/**
+		 * @brief Damaged pixels.
+		 */
+		long long Area() const;
+
+	private:
+		std::vector<DamageRect> m_rects;
+		int m_width;
+		int m_height;
+
+	}; // class DamageRegion
+
+} // namespace Vicetrice
@@ -0,0 +1,72 @@
+#include "Error.hpp"
+
+#if VICE_GL_CHECK != VICE_GL_CHECK_OFF
+
+#include <GL/glew.h>
+#include <iostream>
+
+namespace Vicetrice
+{
+	const char* GLDebug::s_call = "";
+	const char* GLDebug::s_file = "";
+	int GLDebug::s_line = 0;
+	bool GLDebug::s_CheckCalls = false;
+
+	void GLDebug::CheckCall()
+	{
+		bool failed = false;
+		for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError())
+		{
+			std::cerr << "[OpenGL Error] 0x" << std::hex << error << std::dec
+				<< " in " << s_call << " (" << s_file << ":" << s_line << ")" << std::endl;
+			failed = true;
+		}
+
+		if (failed)
+		{
+			//Found the site, back to one check per frame
+			s_CheckCalls = false;
+			assert(!"OpenGL error");
+		}
+	}
+
+	void GLDebug::CheckFrame()
+	{
+		bool failed = false;
+		for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError())
+		{
+			std::cerr << "[OpenGL Error] 0x" << std::hex << error << std::dec
+				<< " during the frame, last call " << s_call << " (" << s_file << ":" << s_line << ")" << std::endl;
+			failed = true;
+		}
+
+		if (failed && !s_CheckCalls)
+		{
+			std::cerr << "[OpenGL Error] checking every call to find the failing one" << std::endl;
+			s_CheckCalls = true;
+		}
+	}
+
+	bool GLDebug::Init()
+	{
+		if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug)
+			return false;
+
+		glEnable(GL_DEBUG_OUTPUT);
+		glDebugMessageCallback(MessageCallback, nullptr);
+		//Notifications come on every buffer upload with some drivers
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+		return true;
+	}
+
+	void GLAPIENTRY GLDebug::MessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* user)
+	{
+		//Asynchronous output, the call site is the last one seen and may be later than the one at fault
+		std::cerr << "[OpenGL "
+			<< (type == GL_DEBUG_TYPE_ERROR ? "Error" : type == GL_DEBUG_TYPE_PERFORMANCE ? "Performance" : "Message")
+			<< "] " << message << " (near " << s_call << ", " << s_file << ":" << s_line << ")" << std::endl;
+	}
+
+} // namespace Vicetrice
+
+#endif
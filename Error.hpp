@@ -3,4 +3,105 @@
 #include <GL/glew.h>
 #include <cassert>
 
-#define GLCall(x) x;assert(glGetError() == GL_NO_ERROR)
+/**
+ * GL error checking, the strategy is chosen at compile time with VICE_GL_CHECK:
+ *
+ *	VICE_GL_CHECK_OFF        GLCall(x) only makes the call, the default with NDEBUG
+ *	VICE_GL_CHECK_PER_CALL   glGetError after every call, reports the call site and asserts (a driver round trip per call)
+ *	VICE_GL_CHECK_PER_FRAME  GLCall only remembers the call site, VICE_GL_CHECK_FRAME() polls glGetError once per frame
+ *	                         and on an error switches to checking every call until the failing site is found,
+ *	                         the default without NDEBUG
+ *
+ *	VICE_GL_DEBUG_INIT()  installs the KHR_debug message callback when the context has it, messages are asynchronous
+ *	                      and report the last call site seen
+ *	VICE_GL_CHECK_FRAME() call once per frame, after the draw calls
+ *
+ * Both macros are nothing with VICE_GL_CHECK_OFF.
+ *
+ * GLCall(x) is a single statement in every mode, safe under an unbraced if, and x is a call or an
+ * assignment: declare the variable before it, a declaration inside would not outlive the statement.
+ */
+
+#define VICE_GL_CHECK_OFF 0
+#define VICE_GL_CHECK_PER_CALL 1
+#define VICE_GL_CHECK_PER_FRAME 2
+
+#ifndef VICE_GL_CHECK
+#ifdef NDEBUG
+#define VICE_GL_CHECK VICE_GL_CHECK_OFF
+#else
+#define VICE_GL_CHECK VICE_GL_CHECK_PER_FRAME
+#endif
+#endif
+
+#if VICE_GL_CHECK == VICE_GL_CHECK_OFF
+
+#define GLCall(x) do { x; } while (0)
+#define VICE_GL_DEBUG_INIT() ((void)0)
+#define VICE_GL_CHECK_FRAME() ((void)0)
+
+#else
+
+#if VICE_GL_CHECK == VICE_GL_CHECK_PER_CALL
+#define GLCall(x) do { ::Vicetrice::GLDebug::Site(#x, __FILE__, __LINE__); x; ::Vicetrice::GLDebug::CheckCall(); } while (0)
+#else
+#define GLCall(x) do { ::Vicetrice::GLDebug::Site(#x, __FILE__, __LINE__); x; if (::Vicetrice::GLDebug::CheckingCalls()) ::Vicetrice::GLDebug::CheckCall(); } while (0)
+#endif
+
+#define VICE_GL_DEBUG_INIT() ::Vicetrice::GLDebug::Init()
+#define VICE_GL_CHECK_FRAME() ::Vicetrice::GLDebug::CheckFrame()
+
+namespace Vicetrice
+{
+	/**
+	 * @brief State behind GLCall, only compiled in when VICE_GL_CHECK is not VICE_GL_CHECK_OFF.
+	 */
+	class GLDebug
+	{
+	public:
+
+		/**
+		 * @brief Remembers the call about to be made, a few stores and no GL call.
+		 */
+		static inline void Site(const char* call, const char* file, int line)
+		{
+			s_call = call;
+			s_file = file;
+			s_line = line;
+		}
+
+		/**
+		 * @brief True while every GLCall has to be checked.
+		 */
+		static inline bool CheckingCalls() { return s_CheckCalls; }
+
+		/**
+		 * @brief Drains glGetError, reports the errors with the last call site and asserts.
+		 */
+		static void CheckCall();
+
+		/**
+		 * @brief Drains glGetError once for the whole frame, on an error the next calls are checked one by one.
+		 */
+		static void CheckFrame();
+
+		/**
+		 * @brief Installs the KHR_debug message callback if the context supports it.
+		 *
+		 * @return True if the callback is installed.
+		 */
+		static bool Init();
+
+	private:
+		static const char* s_call;
+		static const char* s_file;
+		static int s_line;
+		static bool s_CheckCalls;
+
+		static void GLAPIENTRY MessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* user);
+
+	}; // class GLDebug
+
+} // namespace Vicetrice
+
+#endif
@@ -0,0 +1,218 @@
+#include "Font.hpp"
+#include "Profiler.hpp"
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+// The packer of the atlas, imstb_truetype would declare a simpler one of its own without it
+#include "vendor/imgui/imstb_rectpack.h"
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "vendor/imgui/imstb_truetype.h"
+
+namespace Vicetrice
+{
+	static const std::uint32_t ReplacementCharacter = 0xFFFD;
+
+	static const Glyph EmptyGlyph = { 0, TextureAtlas::NoImage, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	/**
+	 * @brief Reads the code point at it and moves past it, a malformed sequence reads as one ReplacementCharacter.
+	 */
+	static std::uint32_t NextCodepoint(std::string::const_iterator& it, std::string::const_iterator end)
+	{
+		unsigned char lead = static_cast<unsigned char>(*it++);
+		if (lead < 0x80)
+			return lead;
+
+		int trail = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+		if (trail == 0 || lead > 0xF4)
+			return ReplacementCharacter;
+
+		std::uint32_t codepoint = lead & (0x3F >> trail);
+		for (int i = 0; i < trail; i++)
+		{
+			if (it == end || (static_cast<unsigned char>(*it) & 0xC0) != 0x80)
+				return ReplacementCharacter;
+			codepoint = (codepoint << 6) | (static_cast<unsigned char>(*it++) & 0x3F);
+		}
+
+		return codepoint;
+	}
+
+
+	/**
+	 * @brief Font file and the tables stbtt reads from it, the data must not move while info points into it.
+	 */
+	struct Font::Face
+	{
+		std::vector<unsigned char> ttf;
+		stbtt_fontinfo info;
+	};
+
+
+	Font::Font(TextureAtlas& atlas, float PixelHeight)
+		: m_atlas{ atlas },
+		m_PixelHeight{ PixelHeight },
+		m_face{},
+		m_scale{ 0.0f },
+		m_ascent{ 0.0f },
+		m_descent{ 0.0f },
+		m_LineGap{ 0.0f },
+		m_glyphs{},
+		m_runs{},
+		m_coverage{},
+		m_rgba{},
+		m_rasterized{ 0 },
+		m_shaped{ 0 }
+	{
+	}
+
+	Font::~Font()
+	{
+	}
+
+	bool Font::Load(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			m_face.reset();
+			return false;
+		}
+
+		return Load(std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+	}
+
+	bool Font::Load(std::vector<unsigned char> ttf)
+	{
+		m_glyphs.clear();
+		m_runs.clear();
+
+		// Shorter than the offset table stbtt reads before it checks anything
+		if (ttf.size() < 12)
+		{
+			m_face.reset();
+			return false;
+		}
+
+		m_face = std::make_unique<Face>();
+		m_face->ttf = std::move(ttf);
+
+		int offset = stbtt_GetFontOffsetForIndex(m_face->ttf.data(), 0);
+		if (offset < 0 || !stbtt_InitFont(&m_face->info, m_face->ttf.data(), offset))
+		{
+			m_face.reset();
+			return false;
+		}
+
+		int ascent, descent, LineGap;
+		stbtt_GetFontVMetrics(&m_face->info, &ascent, &descent, &LineGap);
+
+		m_scale = stbtt_ScaleForPixelHeight(&m_face->info, m_PixelHeight);
+		m_ascent = ascent * m_scale;
+		m_descent = descent * m_scale;
+		m_LineGap = LineGap * m_scale;
+		return true;
+	}
+
+	const Glyph& Font::GetGlyph(std::uint32_t codepoint)
+	{
+		if (!m_face)
+			return EmptyGlyph;
+
+		auto it = m_glyphs.find(codepoint);
+		if (it != m_glyphs.end())
+			return it->second;
+
+		return m_glyphs.emplace(codepoint, Rasterize(codepoint)).first->second;
+	}
+
+	const TextRun& Font::Shape(const std::string& text)
+	{
+		auto it = m_runs.find(text);
+		if (it != m_runs.end())
+			return it->second;
+
+		VICE_PROFILE_ZONE("Font::Shape");
+
+		if (m_runs.size() == MaxRuns)
+			m_runs.clear();
+
+		TextRun& run = m_runs[text];
+		run.width = 0.0f;
+		++m_shaped;
+
+		if (!m_face)
+			return run;
+
+		// The pen is kept in fractional pixels, each glyph is placed on the whole pixel under it
+		float pen = 0.0f;
+		int previous = 0;
+
+		for (auto c = text.cbegin(); c != text.cend();)
+		{
+			const Glyph& glyph = GetGlyph(NextCodepoint(c, text.cend()));
+
+			if (previous != 0)
+				pen += m_scale * stbtt_GetGlyphKernAdvance(&m_face->info, previous, glyph.index);
+
+			if (glyph.image != TextureAtlas::NoImage)
+			{
+				float left = std::floor(pen + 0.5f) + glyph.left;
+				run.quads.push_back({ { left, glyph.top, left + glyph.width, glyph.top + glyph.height }, glyph.image });
+			}
+
+			pen += glyph.advance;
+			previous = glyph.index;
+		}
+
+		run.width = std::ceil(pen);
+		return run;
+	}
+
+	Glyph Font::Rasterize(std::uint32_t codepoint)
+	{
+		VICE_PROFILE_ZONE("Font::Rasterize");
+
+		const stbtt_fontinfo& info = m_face->info;
+		Glyph glyph = EmptyGlyph;
+
+		// A code point missing from the font draws the missing glyph of the font, glyph 0
+		glyph.index = stbtt_FindGlyphIndex(&info, static_cast<int>(codepoint));
+
+		int advance, bearing;
+		stbtt_GetGlyphHMetrics(&info, glyph.index, &advance, &bearing);
+		glyph.advance = advance * m_scale;
+
+		int x0, y0, x1, y1;
+		stbtt_GetGlyphBitmapBox(&info, glyph.index, m_scale, m_scale, &x0, &y0, &x1, &y1);
+		int width = x1 - x0;
+		int height = y1 - y0;
+		if (width <= 0 || height <= 0)
+			return glyph;
+
+		m_coverage.resize(static_cast<std::size_t>(width) * height);
+		stbtt_MakeGlyphBitmap(&info, m_coverage.data(), width, height, width, m_scale, m_scale, glyph.index);
+
+		// White, the quad drawing it brings the color
+		m_rgba.resize(m_coverage.size() * 4);
+		for (std::size_t i = 0; i < m_coverage.size(); i++)
+		{
+			m_rgba[i * 4 + 0] = 255;
+			m_rgba[i * 4 + 1] = 255;
+			m_rgba[i * 4 + 2] = 255;
+			m_rgba[i * 4 + 3] = m_coverage[i];
+		}
+
+		glyph.image = m_atlas.Add(m_rgba.data(), width, height);
+		glyph.left = static_cast<float>(x0);
+		glyph.top = static_cast<float>(y0);
+		glyph.width = static_cast<float>(width);
+		glyph.height = static_cast<float>(height);
+		++m_rasterized;
+
+		return glyph;
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Layout.hpp"
+#include "TextureAtlas.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Glyph of a Font, rasterized into its atlas the first time it is used.
+	 */
+	struct Glyph
+	{
+		int index;                     /// Glyph of the font file, for kerning.
+		unsigned int image;            /// Coverage in the atlas, NoImage when there is nothing to draw (space) or it did not fit.
+		float left;                    /// Offset of the image from the pen, in pixels.
+		float top;                     /// Offset of the image from the baseline, negative above it.
+		float width;
+		float height;
+		float advance;                 /// Distance to the pen of the next glyph, kerning aside.
+	};
+
+	/**
+	 * @brief A string laid out on one line, kept by Font::Shape.
+	 */
+	struct TextRun
+	{
+		struct Quad
+		{
+			LayoutRect rect;           /// In pixels from the pen at the start of the baseline.
+			unsigned int image;
+		};
+
+		std::vector<Quad> quads;       /// One per glyph that draws something, in order.
+		float width;                   /// Advance of the whole string.
+	};
+
+	/**
+	 * @brief TrueType font at one pixel height, its glyphs rasterized on demand into a TextureAtlas.
+	 *
+	 * A glyph is rasterized (imstb_truetype) the first time a string uses it and stays in the atlas
+	 * as white with its coverage as alpha, so a batch shader tints it with the color of its quad and
+	 * text draws in the same batch as everything else. Shape lays out a string once and caches the
+	 * result by string: drawing the same label again, or tessellating it again after a scroll, costs
+	 * a hash lookup. Every call is made from the thread that owns the GL context.
+	 */
+	class Font
+	{
+	public:
+
+		/**
+		 * @brief Runs kept by Shape, the cache starts over when it is full.
+		 */
+		static const std::size_t MaxRuns = 4096;
+
+		/**
+		 * @param atlas Atlas the glyphs go to, it must outlive the font.
+		 * @param PixelHeight Height from the highest ascender to the lowest descender, in pixels.
+		 */
+		Font(TextureAtlas& atlas, float PixelHeight);
+
+		~Font();
+
+		Font(const Font&) = delete;
+		Font& operator=(const Font&) = delete;
+
+		/**
+		 * @brief Reads a TrueType file, the glyphs of a font loaded before stay in the atlas.
+		 *
+		 * @return False if it cannot be read or is not a font, the font is then empty.
+		 */
+		bool Load(const std::string& path);
+
+		/**
+		 * @brief Uses a TrueType file already in memory.
+		 */
+		bool Load(std::vector<unsigned char> ttf);
+
+		inline bool Loaded() const { return m_face != nullptr; }
+
+		inline float PixelHeight() const { return m_PixelHeight; }
+
+		/**
+		 * @brief Distance from the baseline to the top of the highest glyph, in pixels.
+		 */
+		inline float Ascent() const { return m_ascent; }
+
+		/**
+		 * @brief Distance from the baseline to the bottom of the lowest glyph, negative.
+		 */
+		inline float Descent() const { return m_descent; }
+
+		/**
+		 * @brief Distance between two baselines.
+		 */
+		inline float LineHeight() const { return m_ascent - m_descent + m_LineGap; }
+
+		/**
+		 * @brief Glyph of a code point, rasterized if it is not in the atlas yet.
+		 *
+		 * @return Valid as long as the font, nothing is drawn for it while the font is empty.
+		 */
+		const Glyph& GetGlyph(std::uint32_t codepoint);
+
+		/**
+		 * @brief Lays out an UTF-8 string on one line, kerned, each glyph on a whole pixel.
+		 *
+		 * @return Valid until the next call.
+		 */
+		const TextRun& Shape(const std::string& text);
+
+		/**
+		 * @brief Glyphs rasterized so far.
+		 */
+		inline unsigned int Rasterized() const { return m_rasterized; }
+
+		/**
+		 * @brief Strings laid out so far, the calls to Shape that missed the cache.
+		 */
+		inline unsigned long long Shaped() const { return m_shaped; }
+
+	private:
+		struct Face;
+
+		TextureAtlas& m_atlas;
+		float m_PixelHeight;
+		std::unique_ptr<Face> m_face;  /// Font file, null while empty.
+		float m_scale;                 /// Pixels per font unit.
+		float m_ascent;
+		float m_descent;
+		float m_LineGap;
+		std::unordered_map<std::uint32_t, Glyph> m_glyphs;
+		std::unordered_map<std::string, TextRun> m_runs;
+		std::vector<unsigned char> m_coverage; /// Rasterized glyph, reused.
+		std::vector<unsigned char> m_rgba;     /// Rasterized glyph expanded for the atlas, reused.
+		unsigned int m_rasterized;
+		unsigned long long m_shaped;
+
+		/**
+		 * @brief Rasterizes a glyph into the atlas.
+		 */
+		Glyph Rasterize(std::uint32_t codepoint);
+
+	}; // class Font
+
+} // namespace Vicetrice
@@ -0,0 +1,59 @@
+#include "FrameBuffer.hpp"
+#include "Backend.hpp"
+#include <GL/glew.h>
+
+namespace Vicetrice
+{
+	FrameBuffer::FrameBuffer(int width, int height)
+		: m_RendererID{ 0 },
+		m_color{ 0 },
+		m_width{ 0 },
+		m_height{ 0 }
+	{
+		Backend& backend = Backend::Get();
+
+		m_RendererID = backend.GenFramebuffer();
+		m_color = backend.GenRenderbuffer();
+
+		Resize(width, height);
+
+		backend.BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+		backend.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_color);
+		backend.BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	FrameBuffer::~FrameBuffer()
+	{
+		Backend::Get().DeleteFramebuffer(m_RendererID);
+		Backend::Get().DeleteRenderbuffer(m_color);
+	}
+
+	void FrameBuffer::Resize(int width, int height)
+	{
+		m_width = width > 0 ? width : 1;
+		m_height = height > 0 ? height : 1;
+
+		Backend::Get().RenderbufferStorage(m_color, GL_RGBA8, m_width, m_height);
+	}
+
+	void FrameBuffer::Bind() const
+	{
+		Backend::Get().BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+	}
+
+	void FrameBuffer::Unbind() const
+	{
+		Backend::Get().BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void FrameBuffer::Present() const
+	{
+		Backend& backend = Backend::Get();
+
+		backend.BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+		backend.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		backend.BlitFramebuffer(0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT);
+		backend.BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,53 @@
+#pragma once
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Offscreen color buffer the frame is drawn into and then copied to the window.
+	 *
+	 * The back buffer of the window is undefined after a swap, this one keeps its contents between
+	 * frames, so only the damaged parts need to be drawn again. The copy to the window is a blit, it
+	 * fails on a multisampled window framebuffer.
+	 */
+	class FrameBuffer
+	{
+	public:
+		FrameBuffer(int width, int height);
+
+		~FrameBuffer();
+
+		FrameBuffer(const FrameBuffer&) = delete;
+		FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+		/**
+		 * @brief Reallocates the color buffer, the contents are lost.
+		 */
+		void Resize(int width, int height);
+
+		/**
+		 * @brief Makes the draw calls go to this buffer.
+		 */
+		void Bind() const;
+
+		/**
+		 * @brief Makes the draw calls go to the window again.
+		 */
+		void Unbind() const;
+
+		/**
+		 * @brief Copies the whole buffer to the window framebuffer and leaves the window bound.
+		 */
+		void Present() const;
+
+		inline int Width() const { return m_width; }
+		inline int Height() const { return m_height; }
+
+	private:
+		unsigned int m_RendererID;
+		unsigned int m_color;
+		int m_width;
+		int m_height;
+
+	}; // class FrameBuffer
+
+} // namespace Vicetrice
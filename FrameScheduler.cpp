@@ -0,0 +1,167 @@
+#include "FrameScheduler.hpp"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <iomanip>
+
+namespace Vicetrice
+{
+	static const std::size_t RecentFrames = 256;
+
+	static FrameScheduler::Clock::duration Seconds(double seconds)
+	{
+		return std::chrono::duration_cast<FrameScheduler::Clock::duration>(std::chrono::duration<double>(seconds));
+	}
+
+
+	FrameScheduler::FrameScheduler(double RefreshInterval)
+		: m_RefreshInterval{ Seconds(RefreshInterval) },
+		m_requested{ false },
+		m_NextFrame{},
+		m_FrameStart{},
+		m_timers{},
+		m_FrameTimes{},
+		m_frames{ 0 },
+		m_wakeups{ 0 }
+	{
+		m_FrameTimes.reserve(RecentFrames);
+	}
+
+	void FrameScheduler::Wait()
+	{
+		double timeout = Timeout();
+
+		if (timeout < 0.0)
+			glfwWaitEvents();
+		else if (timeout == 0.0)
+			glfwPollEvents();
+		else
+			glfwWaitEventsTimeout(timeout);
+
+		++m_wakeups;
+	}
+
+	double FrameScheduler::Timeout() const
+	{
+		bool pending = m_requested;
+		Clock::time_point deadline = m_requested ? m_NextFrame : Clock::time_point::max();
+
+		for (const Timer& timer : m_timers)
+		{
+			if (timer.active)
+			{
+				deadline = std::min(deadline, timer.next);
+				pending = true;
+			}
+		}
+
+		if (!pending)
+			return -1.0;
+
+		Clock::time_point now = Clock::now();
+		if (deadline <= now)
+			return 0.0;
+
+		return std::chrono::duration<double>(deadline - now).count();
+	}
+
+	bool FrameScheduler::FrameDue() const
+	{
+		return m_requested && Clock::now() >= m_NextFrame;
+	}
+
+	void FrameScheduler::BeginFrame()
+	{
+		m_FrameStart = Clock::now();
+		m_NextFrame = m_FrameStart + m_RefreshInterval;
+		m_requested = false;
+	}
+
+	void FrameScheduler::EndFrame()
+	{
+		float milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - m_FrameStart).count();
+
+		if (m_FrameTimes.size() < RecentFrames)
+			m_FrameTimes.push_back(milliseconds);
+		else
+			m_FrameTimes[m_frames % RecentFrames] = milliseconds;
+
+		++m_frames;
+	}
+
+	unsigned int FrameScheduler::StartTimer(double interval)
+	{
+		Timer timer{ Clock::now() + Seconds(interval), Seconds(interval), true };
+
+		for (unsigned int i = 0; i < m_timers.size(); i++)
+		{
+			if (!m_timers[i].active)
+			{
+				m_timers[i] = timer;
+				return i;
+			}
+		}
+
+		m_timers.push_back(timer);
+		return static_cast<unsigned int>(m_timers.size() - 1);
+	}
+
+	void FrameScheduler::StopTimer(unsigned int timer)
+	{
+		if (timer < m_timers.size())
+			m_timers[timer].active = false;
+	}
+
+	unsigned int FrameScheduler::Expired(unsigned int timer)
+	{
+		if (timer >= m_timers.size() || !m_timers[timer].active)
+			return 0;
+
+		Timer& t = m_timers[timer];
+		Clock::time_point now = Clock::now();
+		if (now < t.next)
+			return 0;
+
+		// Periods missed while the loop was busy are counted, the next one starts from now
+		unsigned int periods = 1 + static_cast<unsigned int>((now - t.next) / t.interval);
+		t.next += periods * t.interval;
+		return periods;
+	}
+
+	void FrameScheduler::SetRefreshInterval(double RefreshInterval)
+	{
+		m_RefreshInterval = Seconds(RefreshInterval);
+	}
+
+	FrameStats FrameScheduler::Stats() const
+	{
+		FrameStats stats;
+		stats.frames = m_frames;
+		stats.wakeups = m_wakeups;
+
+		if (m_FrameTimes.empty())
+			return stats;
+
+		std::vector<float> sorted = m_FrameTimes;
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0.0;
+		for (float time : sorted)
+			total += time;
+
+		stats.average = total / sorted.size();
+		stats.percentile95 = sorted[(sorted.size() - 1) * 95 / 100];
+		stats.worst = sorted.back();
+		return stats;
+	}
+
+	void FrameScheduler::Report(std::ostream& out) const
+	{
+		FrameStats stats = Stats();
+
+		out << std::fixed << std::setprecision(2)
+			<< stats.frames << " frames, " << stats.wakeups << " wakeups, frame time "
+			<< stats.average << " ms average, " << stats.percentile95 << " ms p95, " << stats.worst << " ms worst"
+			<< std::defaultfloat << std::endl;
+	}
+
+} // namespace Vicetrice
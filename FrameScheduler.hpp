@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Frame times of the last frames rendered by a FrameScheduler.
+	 */
+	struct FrameStats
+	{
+		unsigned long long frames = 0;  /// Frames rendered since the start.
+		unsigned long long wakeups = 0; /// Times Wait returned since the start, with or without a frame.
+		double average = 0.0;           /// Milliseconds from BeginFrame to EndFrame, over the recent frames.
+		double percentile95 = 0.0;      /// Milliseconds, 95% of the recent frames took less.
+		double worst = 0.0;             /// Milliseconds, slowest recent frame.
+	};
+
+	/**
+	 * @brief Decides when the main loop sleeps, handles input and renders.
+	 *
+	 * Input is handled as soon as it wakes the loop, a frame is rendered only once one was requested
+	 * and never sooner than a refresh interval after the previous one, so a burst of events costs one
+	 * frame. Between them the thread sleeps in GLFW until an event, a timer or the next allowed frame,
+	 * with nothing pending it sleeps until an event arrives and uses no CPU or GPU at all.
+	 */
+	class FrameScheduler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @param RefreshInterval Seconds between two frames at most, one vsync period.
+		 */
+		explicit FrameScheduler(double RefreshInterval = 1.0 / 60.0);
+
+		/**
+		 * @brief Sleeps until an event arrives, a timer is due or a requested frame may be rendered, GLFW must be initialized.
+		 */
+		void Wait();
+
+		/**
+		 * @brief Seconds Wait sleeps at most, 0 if something is due already and -1 if it only wakes on events.
+		 */
+		double Timeout() const;
+
+		/**
+		 * @brief Asks for a frame, several requests before it is rendered are one frame.
+		 */
+		inline void RequestFrame() { m_requested = true; }
+
+		/**
+		 * @brief Checks if a frame was requested and the refresh interval since the last one has passed.
+		 */
+		bool FrameDue() const;
+
+		/**
+		 * @brief Call before rendering a due frame, clears the request.
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Call once the frame is presented, records its time.
+		 */
+		void EndFrame();
+
+		/**
+		 * @brief Starts a repeating timer, Wait wakes up when a period ends.
+		 *
+		 * A period that ended keeps Wait from sleeping until Expired is called for the timer.
+		 *
+		 * @param interval Seconds between two expirations.
+		 * @return Handle of the timer.
+		 */
+		unsigned int StartTimer(double interval);
+
+		/**
+		 * @brief Stops a timer, the handle may be reused by the next StartTimer.
+		 */
+		void StopTimer(unsigned int timer);
+
+		/**
+		 * @brief Periods of a timer that ended since the last call, 0 for a stopped timer.
+		 */
+		unsigned int Expired(unsigned int timer);
+
+		void SetRefreshInterval(double RefreshInterval);
+
+		FrameStats Stats() const;
+
+		/**
+		 * @brief Writes Stats() on one line.
+		 */
+		void Report(std::ostream& out) const;
+
+	private:
+		struct Timer
+		{
+			Clock::time_point next;    /// End of the current period.
+			Clock::duration interval;
+			bool active;
+		};
+
+		Clock::duration m_RefreshInterval;
+		bool m_requested;              /// A frame was requested and not rendered yet.
+		Clock::time_point m_NextFrame; /// Earliest start of the next frame.
+		Clock::time_point m_FrameStart;
+		std::vector<Timer> m_timers;
+		std::vector<float> m_FrameTimes; /// Milliseconds of the recent frames, a ring indexed by m_frames.
+		unsigned long long m_frames;
+		unsigned long long m_wakeups;
+
+	}; // class FrameScheduler
+
+} // namespace Vicetrice
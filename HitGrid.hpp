@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Uniform grid over the rectangles of many items, answers which one is on top at a point.
+	 *
+	 * Every item is listed in the cells its rectangle covers, a query looks at the items of one cell
+	 * only, so its cost does not grow with the number of items. Moving an item touches the cells it
+	 * leaves and enters, nothing else. Coordinates are cursor pixels and are not bounded, items
+	 * dragged off the context stay indexed. Items are stacked in the order they are added, Raise
+	 * puts one back on top.
+	 */
+	template <typename T>
+	class HitGrid
+	{
+	public:
+
+		/**
+		 * @param CellSize Side of a cell in pixels, about the size of the smallest items.
+		 */
+		HitGrid(double CellSize = 128.0)
+			: m_CellSize{ CellSize },
+			m_NextZ{ 0 },
+			m_entries{},
+			m_cells{}
+		{
+		}
+
+		/**
+		 * @brief Adds an item on top of the others, or moves it to a new rectangle keeping its place in the stack.
+		 */
+		void Update(T* item, double left, double top, double right, double bottom)
+		{
+			auto it = m_entries.find(item);
+
+			if (it == m_entries.end())
+			{
+				Entry entry{ left, top, right, bottom, m_NextZ++, Cell(left), Cell(top), Cell(right), Cell(bottom) };
+				Insert(item, entry);
+				m_entries.emplace(item, entry);
+				return;
+			}
+
+			Entry entry{ left, top, right, bottom, it->second.z, Cell(left), Cell(top), Cell(right), Cell(bottom) };
+
+			if (!SameCells(it->second, entry))
+			{
+				Erase(item, it->second);
+				Insert(item, entry);
+			}
+			it->second = entry;
+		}
+
+		/**
+		 * @brief Puts an item on top of the others, where they overlap it is the one At returns.
+		 */
+		void Raise(T* item)
+		{
+			auto it = m_entries.find(item);
+			if (it != m_entries.end())
+				it->second.z = m_NextZ++;
+		}
+
+		/**
+		 * @brief Forgets an item, nothing happens if it is not indexed.
+		 */
+		void Remove(T* item)
+		{
+			auto it = m_entries.find(item);
+			if (it == m_entries.end())
+				return;
+
+			Erase(item, it->second);
+			m_entries.erase(it);
+		}
+
+		void Clear()
+		{
+			m_entries.clear();
+			m_cells.clear();
+			m_NextZ = 0;
+		}
+
+		inline std::size_t Count() const { return m_entries.size(); }
+
+		/**
+		 * @brief Item on top at a point, nullptr if none covers it.
+		 */
+		T* At(double x, double y) const
+		{
+			auto cell = m_cells.find(Key(Cell(x), Cell(y)));
+			if (cell == m_cells.end())
+				return nullptr;
+
+			T* top = nullptr;
+			std::uint64_t TopZ = 0;
+
+			for (T* item : cell->second)
+			{
+				const Entry& entry = m_entries.at(item);
+				bool inside = x >= entry.left && x <= entry.right && y >= entry.top && y <= entry.bottom;
+
+				if (inside && (top == nullptr || entry.z > TopZ))
+				{
+					top = item;
+					TopZ = entry.z;
+				}
+			}
+			return top;
+		}
+
+	private:
+		struct Entry
+		{
+			double left, top, right, bottom;
+			std::uint64_t z;                /// Stacking order, larger is on top.
+			int CellLeft, CellTop, CellRight, CellBottom;
+		};
+
+		double m_CellSize;
+		std::uint64_t m_NextZ;
+		std::unordered_map<T*, Entry> m_entries;
+		std::unordered_map<std::uint64_t, std::vector<T*>> m_cells; /// Items listed by cell, emptied cells are kept for the next item that enters them.
+
+		inline int Cell(double coordinate) const
+		{
+			return static_cast<int>(std::floor(coordinate / m_CellSize));
+		}
+
+		static inline std::uint64_t Key(int x, int y)
+		{
+			return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+		}
+
+		static inline bool SameCells(const Entry& a, const Entry& b)
+		{
+			return a.CellLeft == b.CellLeft && a.CellTop == b.CellTop && a.CellRight == b.CellRight && a.CellBottom == b.CellBottom;
+		}
+
+		void Insert(T* item, const Entry& entry)
+		{
+			for (int y = entry.CellTop; y <= entry.CellBottom; y++)
+				for (int x = entry.CellLeft; x <= entry.CellRight; x++)
+					m_cells[Key(x, y)].push_back(item);
+		}
+
+		void Erase(T* item, const Entry& entry)
+		{
+			for (int y = entry.CellTop; y <= entry.CellBottom; y++)
+			{
+				for (int x = entry.CellLeft; x <= entry.CellRight; x++)
+				{
+					auto cell = m_cells.find(Key(x, y));
+					if (cell == m_cells.end())
+						continue;
+
+					std::vector<T*>& items = cell->second;
+					auto it = std::find(items.begin(), items.end(), item);
+					if (it != items.end())
+					{
+						*it = items.back();
+						items.pop_back();
+					}
+				}
+			}
+		}
+
+	}; // class HitGrid
+
+} // namespace Vicetrice
@@ -6,6 +6,8 @@
 #include <string>
 #include <cassert>
 #include "vendor/glm/gtc/matrix_transform.hpp"
+#include "InstanceGenerator.hpp"
+#include "TextureAtlas.hpp"
 
 namespace Vicetrice
 {
@@ -13,12 +15,21 @@ namespace Vicetrice
 	class Icon
 	{
 	public:
-		Icon(glm::vec4 color);
+		/**
+		*	@param image Image of the icon in the TextureAtlas, TextureAtlas::NoImage draws it flat
+		*/
+		Icon(glm::vec4 color, unsigned int image = TextureAtlas::NoImage);
 
 		void Draw();
 		virtual void OnClick(void(*func)());
 		void AddIcon();
-		virtual void AddToContext(std::vector<float>& ContextVertices, std::vector<unsigned int>& Indices, bool IsWindow, unsigned int IconNumber) ;
+
+		/**
+		*	@brief Writes the per-instance attributes of the icon (row, color, image) into its fixed slot of the instance buffer.
+		*	@param Instance Slot of the instance buffer
+		*	@param Row Row of the icon, the unit quad is stacked under the previous rows by the icon shader
+		*/
+		virtual void WriteInstance(IconInstance& Instance, int Row) const;
 
 	protected:
 
@@ -26,6 +37,7 @@ namespace Vicetrice
 
 	private:
 		glm::vec4 m_color;
+		unsigned int m_image;
 
 	};
 
@@ -0,0 +1,24 @@
+#include "IconSource.hpp"
+
+namespace Vicetrice
+{
+	unsigned int IconSource::WriteInstances(unsigned int first, unsigned int count, IconInstance* out) const
+	{
+		std::vector<Icon> icons;
+		icons.reserve(count);
+		Fetch(first, count, icons);
+
+		for (unsigned int i = 0; i < icons.size(); ++i)
+		{
+			icons[i].WriteInstance(out[i], static_cast<int>(first + i));
+		}
+
+		return static_cast<unsigned int>(icons.size());
+	}
+
+	std::string IconSource::Label(unsigned int row) const
+	{
+		return std::string();
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Icon.hpp"
+#include "InstanceGenerator.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Interface for the rows shown by a Window.
+	 *
+	 * The window only fetches the rows that are visible, so a source can expose millions
+	 * of rows without materializing them.
+	 */
+	class IconSource
+	{
+	public:
+
+		virtual ~IconSource() = default;
+
+		/**
+		 * @brief Returns the number of rows in the source.
+		 */
+		virtual unsigned int Count() const = 0;
+
+		/**
+		 * @brief Appends the rows [first, first + count) to icons.
+		 *
+		 * @param first Index of the first row.
+		 * @param count Number of rows to fetch.
+		 * @param icons Vector the rows are appended to, reused by the caller between fetches.
+		 */
+		virtual void Fetch(unsigned int first, unsigned int count, std::vector<Icon>& icons) const = 0;
+
+		/**
+		 * @brief Writes the IconInstance records of the rows [first, first + count), back to back.
+		 *
+		 * The default fetches the rows and writes each of them with Icon::WriteInstance, a source that
+		 * keeps its rows in arrays overrides it with a single loop.
+		 *
+		 * @param out Room for count records.
+		 * @return Number of rows written, less than count past the end of the source.
+		 */
+		virtual unsigned int WriteInstances(unsigned int first, unsigned int count, IconInstance* out) const;
+
+		/**
+		 * @brief Text shown on a row, UTF-8. Only asked for the visible rows, when they are tessellated.
+		 *
+		 * @return Empty by default, the row has no label.
+		 */
+		virtual std::string Label(unsigned int row) const;
+
+	}; // class IconSource
+
+} // namespace Vicetrice
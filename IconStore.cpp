@@ -0,0 +1,69 @@
+#include "IconStore.hpp"
+#include "InstanceGenerator.hpp"
+
+namespace Vicetrice
+{
+	unsigned int IconStore::Count() const
+	{
+		return static_cast<unsigned int>(m_colors.size());
+	}
+
+	void IconStore::Fetch(unsigned int first, unsigned int count, std::vector<Icon>& icons) const
+	{
+		unsigned int end = first + count < Count() ? first + count : Count();
+
+		for (unsigned int i = first; i < end; ++i)
+		{
+			icons.emplace_back(m_colors[i], m_images[i]);
+		}
+	}
+
+	unsigned int IconStore::WriteInstances(unsigned int first, unsigned int count, IconInstance* out) const
+	{
+		if (first >= Count())
+			return 0;
+
+		unsigned int end = first + count < Count() ? first + count : Count();
+
+		// Same record Icon::WriteInstance writes: row, color and image
+		InstanceGenerator::Generate(m_colors.data() + first, m_images.data() + first, first, end - first, out);
+
+		return end - first;
+	}
+
+	std::string IconStore::Label(unsigned int row) const
+	{
+		return m_labels[row];
+	}
+
+	void IconStore::Add(const glm::vec4& color, std::uint32_t callback, std::uint32_t image, const std::string& label)
+	{
+		m_colors.push_back(color);
+		m_states.push_back(IconNone);
+		m_callbacks.push_back(callback);
+		m_images.push_back(image);
+		m_labels.push_back(label);
+	}
+
+	void IconStore::RemoveLast()
+	{
+		if (m_colors.empty())
+			return;
+
+		m_colors.pop_back();
+		m_states.pop_back();
+		m_callbacks.pop_back();
+		m_images.pop_back();
+		m_labels.pop_back();
+	}
+
+	void IconStore::Reserve(unsigned int count)
+	{
+		m_colors.reserve(count);
+		m_states.reserve(count);
+		m_callbacks.reserve(count);
+		m_images.reserve(count);
+		m_labels.reserve(count);
+	}
+
+} // namespace Vicetrice
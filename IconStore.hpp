@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "IconSource.hpp"
+#include "TextureAtlas.hpp"
+#include "vendor/glm/glm.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Flags of an icon in an IconStore.
+	 */
+	enum IconState : std::uint8_t
+	{
+		IconNone = 0,
+		IconHovered = 1 << 0,
+		IconPressed = 1 << 1,
+		IconSelected = 1 << 2
+	};
+
+	/**
+	 * @brief Icons kept as parallel arrays, the default source of a Window.
+	 *
+	 * Each attribute lives in its own array indexed by row, there is no Icon object and no virtual
+	 * call per row. WriteInstances generates the instance data of a whole run of rows with the
+	 * InstanceGenerator.
+	 */
+	class IconStore : public IconSource
+	{
+	public:
+
+		unsigned int Count() const override;
+
+		void Fetch(unsigned int first, unsigned int count, std::vector<Icon>& icons) const override;
+
+		unsigned int WriteInstances(unsigned int first, unsigned int count, IconInstance* out) const override;
+
+		std::string Label(unsigned int row) const override;
+
+		/**
+		 * @brief Appends an icon at the end of the store.
+		 *
+		 * @param callback Identifier handed to the click handler of the application, 0 for none.
+		 * @param image Image drawn at the start of the row, see TextureAtlas.
+		 * @param label Text drawn after the image, UTF-8.
+		 */
+		void Add(const glm::vec4& color, std::uint32_t callback = 0, std::uint32_t image = TextureAtlas::NoImage, const std::string& label = std::string());
+
+		/**
+		 * @brief Removes the last icon of the store, if any.
+		 */
+		void RemoveLast();
+
+		void Reserve(unsigned int count);
+
+		inline const glm::vec4& Color(unsigned int row) const { return m_colors[row]; }
+		inline void SetColor(unsigned int row, const glm::vec4& color) { m_colors[row] = color; }
+
+		inline std::uint8_t State(unsigned int row) const { return m_states[row]; }
+		inline void SetState(unsigned int row, std::uint8_t state) { m_states[row] = state; }
+
+		inline std::uint32_t Callback(unsigned int row) const { return m_callbacks[row]; }
+		inline void SetCallback(unsigned int row, std::uint32_t callback) { m_callbacks[row] = callback; }
+
+		inline std::uint32_t Image(unsigned int row) const { return m_images[row]; }
+		inline void SetImage(unsigned int row, std::uint32_t image) { m_images[row] = image; }
+
+		inline void SetLabel(unsigned int row, const std::string& label) { m_labels[row] = label; }
+
+	private:
+		std::vector<glm::vec4> m_colors;       /// RGBA of each row.
+		std::vector<std::uint8_t> m_states;    /// IconState flags of each row.
+		std::vector<std::uint32_t> m_callbacks; /// Click handler identifier of each row.
+		std::vector<std::uint32_t> m_images;   /// TextureAtlas image of each row.
+		std::vector<std::string> m_labels;     /// Label of each row, read only when the row is tessellated.
+
+	}; // class IconStore
+
+} // namespace Vicetrice
@@ -0,0 +1,188 @@
+#include "ImageLoader.hpp"
+#include "Profiler.hpp"
+#include "vendor/stb_image/stb_image.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+namespace Vicetrice
+{
+	static const int Channels = 4;
+
+	/**
+	 * @brief Shrinks an RGBA8 image by a whole factor, averaging each block of factor x factor pixels.
+	 *
+	 * The colors are weighted by their alpha, transparent pixels do not darken the edges.
+	 */
+	static std::vector<unsigned char> Shrink(const unsigned char* pixels, int width, int height, int factor, int& OutWidth, int& OutHeight)
+	{
+		OutWidth = std::max(1, width / factor);
+		OutHeight = std::max(1, height / factor);
+		std::vector<unsigned char> out(static_cast<std::size_t>(OutWidth) * OutHeight * Channels);
+
+		for (int y = 0; y < OutHeight; y++)
+		{
+			for (int x = 0; x < OutWidth; x++)
+			{
+				std::uint64_t sum[Channels] = {};
+				unsigned int count = 0;
+
+				for (int sy = y * factor; sy < std::min((y + 1) * factor, height); sy++)
+				{
+					for (int sx = x * factor; sx < std::min((x + 1) * factor, width); sx++)
+					{
+						const unsigned char* texel = pixels + (static_cast<std::size_t>(sy) * width + sx) * Channels;
+						for (int c = 0; c < 3; c++)
+							sum[c] += texel[c] * texel[3];
+						sum[3] += texel[3];
+						++count;
+					}
+				}
+
+				unsigned char* target = &out[(static_cast<std::size_t>(y) * OutWidth + x) * Channels];
+				for (int c = 0; c < 3; c++)
+					target[c] = static_cast<unsigned char>(sum[3] != 0 ? (sum[c] + sum[3] / 2) / sum[3] : 0);
+				target[3] = static_cast<unsigned char>((sum[3] + count / 2) / count);
+			}
+		}
+
+		return out;
+	}
+
+
+	ImageLoader::ImageLoader(TextureAtlas& atlas, int MaxSize)
+		: m_atlas{ atlas },
+		m_MaxSize{ std::max(MaxSize, 1) },
+		m_pending{ 0 },
+		m_failed{ 0 },
+		m_mutex{},
+		m_wake{},
+		m_jobs{},
+		m_decoded{},
+		m_stop{ false },
+		m_worker{ &ImageLoader::Run, this }
+	{
+		// Clamped in release, Decode divides by it on the worker
+		assert(MaxSize >= 1);
+	}
+
+	ImageLoader::~ImageLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+
+		m_wake.notify_one();
+		m_worker.join();
+	}
+
+	unsigned int ImageLoader::Load(const std::string& path)
+	{
+		return Queue({ TextureAtlas::NoImage, path, {} });
+	}
+
+	unsigned int ImageLoader::Load(std::vector<unsigned char> encoded)
+	{
+		return Queue({ TextureAtlas::NoImage, std::string(), std::move(encoded) });
+	}
+
+	unsigned int ImageLoader::Pump(unsigned int MaxUploads)
+	{
+		VICE_PROFILE_ZONE("ImageLoader::Pump");
+
+		unsigned int uploaded = 0;
+
+		while (uploaded < MaxUploads)
+		{
+			Decoded decoded;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_decoded.empty())
+					break;
+
+				decoded = std::move(m_decoded.front());
+				m_decoded.pop_front();
+			}
+
+			--m_pending;
+
+			// The copy into the texture is the only part done on this thread
+			if (!decoded.pixels.empty() && m_atlas.Upload(decoded.image, decoded.pixels.data(), decoded.width, decoded.height))
+				++uploaded;
+			else
+				++m_failed;
+		}
+
+		return uploaded;
+	}
+
+	unsigned int ImageLoader::Queue(Job job)
+	{
+		job.image = m_atlas.Reserve();
+		if (job.image == TextureAtlas::NoImage)
+			return TextureAtlas::NoImage;
+
+		unsigned int image = job.image;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(std::move(job));
+		}
+
+		++m_pending;
+		m_wake.notify_one();
+		return image;
+	}
+
+	void ImageLoader::Run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		while (true)
+		{
+			m_wake.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+			if (m_stop)
+				return;
+
+			Job job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+
+			// Decoding takes the time, the lock is only held to take and hand over
+			lock.unlock();
+			Decoded decoded = Decode(job);
+			lock.lock();
+
+			m_decoded.push_back(std::move(decoded));
+		}
+	}
+
+	ImageLoader::Decoded ImageLoader::Decode(const Job& job) const
+	{
+		Decoded decoded = { job.image, {}, 0, 0 };
+
+		int width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = job.path.empty()
+			? stbi_load_from_memory(job.encoded.data(), static_cast<int>(job.encoded.size()), &width, &height, &channels, Channels)
+			: stbi_load(job.path.c_str(), &width, &height, &channels, Channels);
+
+		if (pixels == nullptr)
+			return decoded;
+
+		int factor = (std::max(width, height) + m_MaxSize - 1) / m_MaxSize;
+		if (factor > 1)
+		{
+			decoded.pixels = Shrink(pixels, width, height, factor, decoded.width, decoded.height);
+		}
+		else
+		{
+			decoded.pixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * Channels);
+			decoded.width = width;
+			decoded.height = height;
+		}
+
+		stbi_image_free(pixels);
+		return decoded;
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TextureAtlas.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Decodes images on a worker thread and adds them to a TextureAtlas on the render thread.
+	 *
+	 * Load reserves the image in the atlas right away, so the caller can hand it to its icons before
+	 * the file is even read: they are drawn flat until Pump uploads the pixels. Decoding (stb_image)
+	 * and shrinking to MaxSize happen on the worker, Pump only copies finished images into the
+	 * texture, at most a given number per call, so a folder of icons never stalls a frame. Every
+	 * call but the worker's own is made from the thread that owns the GL context.
+	 */
+	class ImageLoader
+	{
+	public:
+
+		/**
+		 * @param atlas Atlas the images go to, it must outlive the loader.
+		 * @param MaxSize Longest side of an image in the atlas, larger ones are shrunk by a whole factor. At least 1.
+		 */
+		ImageLoader(TextureAtlas& atlas, int MaxSize);
+
+		/**
+		 * @brief Stops the worker, the images not uploaded yet stay empty.
+		 */
+		~ImageLoader();
+
+		ImageLoader(const ImageLoader&) = delete;
+		ImageLoader& operator=(const ImageLoader&) = delete;
+
+		/**
+		 * @brief Queues an image file, any format stb_image reads.
+		 *
+		 * @return The image in the atlas, NoImage if it is full.
+		 */
+		unsigned int Load(const std::string& path);
+
+		/**
+		 * @brief Queues an image already in memory, encoded.
+		 */
+		unsigned int Load(std::vector<unsigned char> encoded);
+
+		/**
+		 * @brief Uploads the images decoded so far.
+		 *
+		 * @param MaxUploads Most images uploaded by this call, the rest wait for the next one.
+		 * @return Images uploaded, the ones that failed to decode or to fit are not counted.
+		 */
+		unsigned int Pump(unsigned int MaxUploads = ~0u);
+
+		/**
+		 * @brief Images queued and not uploaded yet.
+		 */
+		inline unsigned int Pending() const { return m_pending; }
+
+		/**
+		 * @brief Images that could not be decoded or did not fit in the atlas.
+		 */
+		inline unsigned int Failed() const { return m_failed; }
+
+	private:
+		struct Job
+		{
+			unsigned int image;
+			std::string path;          /// File to read, empty when the image is in encoded.
+			std::vector<unsigned char> encoded;
+		};
+
+		struct Decoded
+		{
+			unsigned int image;
+			std::vector<unsigned char> pixels; /// RGBA8, empty if decoding failed.
+			int width;
+			int height;
+		};
+
+		TextureAtlas& m_atlas;
+		int m_MaxSize;
+		unsigned int m_pending;
+		unsigned int m_failed;
+
+		std::mutex m_mutex;            /// Guards the members below.
+		std::condition_variable m_wake;
+		std::deque<Job> m_jobs;
+		std::deque<Decoded> m_decoded;
+		bool m_stop;
+
+		std::thread m_worker;          /// Started last, the members above exist before it runs.
+
+		unsigned int Queue(Job job);
+
+		/**
+		 * @brief Body of the worker: decodes jobs until the loader stops.
+		 */
+		void Run();
+
+		/**
+		 * @brief Decodes one job, shrinking the image to m_MaxSize.
+		 */
+		Decoded Decode(const Job& job) const;
+
+	}; // class ImageLoader
+
+} // namespace Vicetrice
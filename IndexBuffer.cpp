@@ -1,5 +1,7 @@
 #include "IndexBuffer.hpp"
-#include "Error.hpp"
+#include "Backend.hpp"
+#include <cassert>
+#include "Profiler.hpp"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
@@ -11,38 +13,68 @@ namespace Vicetrice
 
 		assert(sizeof(unsigned int) == sizeof(GLuint));
 
-		GLCall(glGenBuffers(1, &m_RendererID));
+		m_RendererID = Backend::Get().GenBuffer();
 
 
-		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+		Backend::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 
 
-		GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count, data, GL_DYNAMIC_DRAW));
+		Backend::Get().BufferData(GL_ELEMENT_ARRAY_BUFFER, count, data, GL_DYNAMIC_DRAW);
 
 	}
 
 
 	IndexBuffer::~IndexBuffer()
 	{
-		GLCall(glDeleteBuffers(1, &m_RendererID));
+		Backend::Get().DeleteBuffer(m_RendererID);
 	}
 
 	void IndexBuffer::Update(const void* data, unsigned int count, unsigned int offset)
 	{
 
-		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-		GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, count , data));
+		Backend::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		Backend::Get().BufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, count, data);
+		VICE_PROFILE_COUNT(BufferBytes, count);
+	}
+
+	void IndexBuffer::Allocate(const void* data, unsigned int count)
+	{
+		m_Count = count;
+
+		Backend::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		Backend::Get().BufferData(GL_ELEMENT_ARRAY_BUFFER, count, data, GL_DYNAMIC_DRAW);
+		VICE_PROFILE_COUNT(BufferBytes, count);
+	}
+
+	std::vector<unsigned int> IndexBuffer::QuadPattern(unsigned int QuadCount)
+	{
+		std::vector<unsigned int> indices(static_cast<size_t>(QuadCount) * 6);
+
+		for (unsigned int k = 0; k < QuadCount; ++k)
+		{
+			unsigned int* quad = &indices[static_cast<size_t>(k) * 6];
+			unsigned int base = k * 4;
+
+			quad[0] = base;
+			quad[1] = base + 1;
+			quad[2] = base + 2;
+			quad[3] = base;
+			quad[4] = base + 2;
+			quad[5] = base + 3;
+		}
+
+		return indices;
 	}
 
 	void IndexBuffer::Bind() const
 	{
 
-		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+		Backend::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 
 	}
 
 	void IndexBuffer::Unbind() const
 	{
-		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+		Backend::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 namespace Vicetrice
 {
 	class IndexBuffer
@@ -11,10 +13,17 @@ namespace Vicetrice
 
 
 		void Update(const void* data, unsigned int count, unsigned int offset = 0);
+		void Allocate(const void* data, unsigned int count);
 		void Bind() const;
 		void Unbind() const;
 		inline unsigned int GetCount() const { return m_Count; }
 
+		/**
+		*	@brief Builds the index pattern of independent quads (0,1,2,0,2,3 + 4k)
+		*	@param QuadCount number of quads in the pattern
+		*/
+		static std::vector<unsigned int> QuadPattern(unsigned int QuadCount);
+
 
 	private:
 		unsigned int m_RendererID;
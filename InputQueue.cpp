@@ -0,0 +1,63 @@
+#include "InputQueue.hpp"
+
+namespace Vicetrice
+{
+	InputQueue::InputQueue()
+		: m_events{},
+		m_CursorX{ 0.0 },
+		m_CursorY{ 0.0 },
+		m_received{ 0 },
+		m_drained{ 0 }
+	{
+	}
+
+	void InputQueue::PushCursor(double x, double y)
+	{
+		++m_received;
+		m_CursorX = x;
+		m_CursorY = y;
+
+		if (!m_events.empty() && m_events.back().type == InputType::CursorPosition)
+		{
+			m_events.back().x = x;
+			m_events.back().y = y;
+			return;
+		}
+
+		m_events.push_back({ InputType::CursorPosition, 0, 0, x, y });
+	}
+
+	void InputQueue::PushButton(int button, int action)
+	{
+		++m_received;
+		m_events.push_back({ InputType::MouseButton, button, action, m_CursorX, m_CursorY });
+	}
+
+	void InputQueue::PushKey(int key, int action)
+	{
+		++m_received;
+		m_events.push_back({ InputType::Key, key, action, m_CursorX, m_CursorY });
+	}
+
+	void InputQueue::PushContextSize(int width, int height)
+	{
+		++m_received;
+
+		if (!m_events.empty() && m_events.back().type == InputType::ContextSize)
+		{
+			m_events.back().x = width;
+			m_events.back().y = height;
+			return;
+		}
+
+		m_events.push_back({ InputType::ContextSize, 0, 0, static_cast<double>(width), static_cast<double>(height) });
+	}
+
+	void InputQueue::Drain(std::vector<InputEvent>& events)
+	{
+		events.clear();
+		events.swap(m_events);
+		m_drained += events.size();
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Kind of an input event.
+	 */
+	enum class InputType
+	{
+		ContextSize,
+		MouseButton,
+		CursorPosition,
+		Key,
+	};
+
+	/**
+	 * @brief One input event, the fields used depend on the type.
+	 */
+	struct InputEvent
+	{
+		InputType type;
+		int button;  /// MouseButton: GLFW button, Key: GLFW key
+		int action;  /// MouseButton, Key: GLFW_PRESS or GLFW_RELEASE
+		double x;    /// MouseButton, CursorPosition: cursor position, ContextSize: width
+		double y;    /// MouseButton, CursorPosition: cursor position, ContextSize: height
+	};
+
+	/**
+	 * @brief Collects the GLFW callbacks between frames and hands them out all at once.
+	 *
+	 * Consecutive cursor moves are coalesced into the last one, and so are consecutive context resizes.
+	 * Button and key transitions are never merged and keep their order and the cursor position they happened at,
+	 * so a press and release between two frames are both seen.
+	 */
+	class InputQueue
+	{
+	public:
+
+		InputQueue();
+
+		/**
+		 * @brief Queues a cursor move, replacing the previous event if it was a cursor move too.
+		 */
+		void PushCursor(double x, double y);
+
+		/**
+		 * @brief Queues a button transition at the last known cursor position.
+		 */
+		void PushButton(int button, int action);
+
+		/**
+		 * @brief Queues a key transition, key repeats are left to the application.
+		 */
+		void PushKey(int key, int action);
+
+		/**
+		 * @brief Queues a context resize, replacing the previous event if it was a resize too.
+		 */
+		void PushContextSize(int width, int height);
+
+		/**
+		 * @brief Moves the queued events into events, in order.
+		 *
+		 * @param events Receives the events, its previous contents are dropped and its storage is reused by the queue.
+		 */
+		void Drain(std::vector<InputEvent>& events);
+
+		inline bool Empty() const { return m_events.empty(); }
+
+		/**
+		 * @brief Events pushed since the start, coalesced or not.
+		 */
+		inline unsigned long long Received() const { return m_received; }
+
+		/**
+		 * @brief Events handed out by Drain since the start.
+		 */
+		inline unsigned long long Drained() const { return m_drained; }
+
+	private:
+		std::vector<InputEvent> m_events;
+		double m_CursorX;
+		double m_CursorY;
+		unsigned long long m_received;
+		unsigned long long m_drained;
+
+	}; // class InputQueue
+
+} // namespace Vicetrice
@@ -0,0 +1,244 @@
+#include "InstanceGenerator.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VICE_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles any intrinsic, GCC and Clang need the functions that use them marked with their target
+#if defined(VICE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define VICE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VICE_TARGET(isa)
+#endif
+
+namespace Vicetrice
+{
+	using GenerateFunction = void(*)(const glm::vec4*, const std::uint32_t*, unsigned int, unsigned int, IconInstance*);
+
+	static void GenerateScalar(const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const glm::vec4& color = colors[i];
+
+			out[i].row = static_cast<std::int32_t>(first + i);
+			out[i].color[0] = PackUnorm8(color.r);
+			out[i].color[1] = PackUnorm8(color.g);
+			out[i].color[2] = PackUnorm8(color.b);
+			out[i].color[3] = PackUnorm8(color.a);
+			out[i].image = images[i];
+		}
+	}
+
+#ifdef VICE_SIMD_X86
+
+	/**
+	 * @brief Clamps, scales and rounds 4 channels to 0..255 in 32-bit lanes, PackUnorm8 without the narrowing.
+	 */
+	VICE_TARGET("sse4.1")
+	static inline __m128i ScaleUnorm8(__m128 color)
+	{
+		color = _mm_min_ps(_mm_max_ps(color, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+	}
+
+	/**
+	 * @brief Four rows per iteration, three 4-word stores of rows R, packed colors C and images I:
+	 * [R0 C0 I0 R1] [C1 I1 R2 C2] [I2 R3 C3 I3]
+	 */
+	VICE_TARGET("sse4.1")
+	static void GenerateSSE41(const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out)
+	{
+		const float* source = &colors[0].r;
+		__m128i* target = reinterpret_cast<__m128i*>(out);
+		unsigned int i = 0;
+
+		__m128i rows = _mm_setr_epi32(static_cast<int>(first), static_cast<int>(first + 1), static_cast<int>(first + 2), static_cast<int>(first + 3));
+		const __m128i step = _mm_set1_epi32(4);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i c01 = _mm_packus_epi32(ScaleUnorm8(_mm_loadu_ps(source + 4 * i)), ScaleUnorm8(_mm_loadu_ps(source + 4 * i + 4)));
+			__m128i c23 = _mm_packus_epi32(ScaleUnorm8(_mm_loadu_ps(source + 4 * i + 8)), ScaleUnorm8(_mm_loadu_ps(source + 4 * i + 12)));
+			__m128i packed = _mm_packus_epi16(c01, c23);
+			__m128i imgs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(images + i));
+
+			__m128i lo = _mm_unpacklo_epi32(rows, packed); // R0 C0 R1 C1
+			__m128i hi = _mm_unpackhi_epi32(rows, packed); // R2 C2 R3 C3
+			__m128i ir = _mm_unpacklo_epi32(imgs, rows);    // I0 R0 I1 R1
+
+			// Words taken from the images by the blends: 1 of [C1 I1 ..], 0 and 3 of [I2 R3 C3 I3]
+			__m128i s0 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(ir), _MM_SHUFFLE(3, 0, 1, 0)));
+			__m128i c1i1 = _mm_blend_epi16(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 3, 3, 3)), imgs, 0x0C);
+			__m128i s1 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(c1i1), _mm_castsi128_ps(hi), _MM_SHUFFLE(1, 0, 1, 0)));
+			__m128i s2 = _mm_blend_epi16(_mm_shuffle_epi32(hi, _MM_SHUFFLE(0, 3, 2, 0)), _mm_shuffle_epi32(imgs, _MM_SHUFFLE(3, 0, 0, 2)), 0xC3);
+
+			_mm_storeu_si128(target, s0);
+			_mm_storeu_si128(target + 1, s1);
+			_mm_storeu_si128(target + 2, s2);
+			target += 3;
+
+			rows = _mm_add_epi32(rows, step);
+		}
+
+		GenerateScalar(colors + i, images + i, first + i, count - i, out + i);
+	}
+
+	VICE_TARGET("avx2")
+	static inline __m256i ScaleUnorm8(__m256 color)
+	{
+		color = _mm256_min_ps(_mm256_max_ps(color, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+		return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(color, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+	}
+
+	/**
+	 * @brief Eight rows per iteration, the SSE shuffles on both 128-bit lanes, which hold rows 0-3 and 4-7,
+	 * then three 8-word stores that take the lanes in order.
+	 */
+	VICE_TARGET("avx2")
+	static void GenerateAVX2(const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out)
+	{
+		const float* source = &colors[0].r;
+		__m256i* target = reinterpret_cast<__m256i*>(out);
+		unsigned int i = 0;
+
+		// The packs work per lane and leave the colors as C0 C2 C4 C6 | C1 C3 C5 C7
+		const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+		__m256i rows = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		const __m256i step = _mm256_set1_epi32(8);
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i c01 = _mm256_packus_epi32(ScaleUnorm8(_mm256_loadu_ps(source + 4 * i)), ScaleUnorm8(_mm256_loadu_ps(source + 4 * i + 8)));
+			__m256i c23 = _mm256_packus_epi32(ScaleUnorm8(_mm256_loadu_ps(source + 4 * i + 16)), ScaleUnorm8(_mm256_loadu_ps(source + 4 * i + 24)));
+			__m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(c01, c23), order);
+			__m256i imgs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(images + i));
+
+			__m256i lo = _mm256_unpacklo_epi32(rows, packed);
+			__m256i hi = _mm256_unpackhi_epi32(rows, packed);
+			__m256i ir = _mm256_unpacklo_epi32(imgs, rows);
+
+			__m256i s0 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(ir), _MM_SHUFFLE(3, 0, 1, 0)));
+			__m256i c1i1 = _mm256_blend_epi16(_mm256_shuffle_epi32(lo, _MM_SHUFFLE(3, 3, 3, 3)), imgs, 0x0C);
+			__m256i s1 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(c1i1), _mm256_castsi256_ps(hi), _MM_SHUFFLE(1, 0, 1, 0)));
+			__m256i s2 = _mm256_blend_epi16(_mm256_shuffle_epi32(hi, _MM_SHUFFLE(0, 3, 2, 0)), _mm256_shuffle_epi32(imgs, _MM_SHUFFLE(3, 0, 0, 2)), 0xC3);
+
+			_mm256_storeu_si256(target, _mm256_permute2x128_si256(s0, s1, 0x20));
+			_mm256_storeu_si256(target + 1, _mm256_permute2x128_si256(s2, s0, 0x30));
+			_mm256_storeu_si256(target + 2, _mm256_permute2x128_si256(s1, s2, 0x31));
+			target += 3;
+
+			rows = _mm256_add_epi32(rows, step);
+		}
+
+		// The tail is a sibling call the compiler emits without vzeroupper, dirty upper halves slow down every SSE instruction after it
+		_mm256_zeroupper();
+		GenerateSSE41(colors + i, images + i, first + i, count - i, out + i);
+	}
+
+	static SimdPath DetectSimd()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		int highest = info[0];
+
+		__cpuid(info, 1);
+		bool sse41 = (info[2] & (1 << 19)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		// The OS must save the YMM registers too
+		bool ymm = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+		bool avx2 = false;
+		if (ymm && highest >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		bool sse41 = __builtin_cpu_supports("sse4.1");
+		bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		if (avx2)
+			return SimdPath::AVX2;
+		if (sse41)
+			return SimdPath::SSE41;
+		return SimdPath::Scalar;
+	}
+
+#else
+
+	static SimdPath DetectSimd()
+	{
+		return SimdPath::Scalar;
+	}
+
+#endif
+
+	static GenerateFunction Function(SimdPath path)
+	{
+		switch (path)
+		{
+#ifdef VICE_SIMD_X86
+		case SimdPath::AVX2:
+			return GenerateAVX2;
+		case SimdPath::SSE41:
+			return GenerateSSE41;
+#endif
+		default:
+			return GenerateScalar;
+		}
+	}
+
+	static const SimdPath s_supported = DetectSimd();
+	static SimdPath s_active = s_supported;
+	static GenerateFunction s_generate = Function(s_supported);
+
+
+	void InstanceGenerator::Generate(const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out)
+	{
+		s_generate(colors, images, first, count, out);
+	}
+
+	void InstanceGenerator::Generate(SimdPath path, const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out)
+	{
+		Function(path)(colors, images, first, count, out);
+	}
+
+	SimdPath InstanceGenerator::Supported()
+	{
+		return s_supported;
+	}
+
+	SimdPath InstanceGenerator::Active()
+	{
+		return s_active;
+	}
+
+	void InstanceGenerator::SetActive(SimdPath path)
+	{
+		s_active = path < s_supported ? path : s_supported;
+		s_generate = Function(s_active);
+	}
+
+	const char* InstanceGenerator::Name(SimdPath path)
+	{
+		switch (path)
+		{
+		case SimdPath::AVX2:
+			return "avx2";
+		case SimdPath::SSE41:
+			return "sse41";
+		default:
+			return "scalar";
+		}
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "vendor/glm/glm.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Per-instance data of an icon row as the icon shader reads it, 12 bytes.
+	 *
+	 * The row and the image are integer attributes, the color is RGBA8 normalized by the vertex fetch.
+	 */
+	struct IconInstance
+	{
+		std::int32_t row;              /// Row of the icon, -1 leaves the unit quad where the matrix puts it.
+		std::uint8_t color[4];         /// RGBA.
+		std::uint32_t image;           /// Image of the icon in the TextureAtlas, TextureAtlas::NoImage for none.
+	};
+
+	static_assert(sizeof(IconInstance) == 12, "IconInstance must match the instance layout of the icon shader");
+
+	/**
+	 * @brief Converts a color channel in [0, 1] to 8 bits, rounding to nearest like the SIMD paths.
+	 */
+	inline std::uint8_t PackUnorm8(float value)
+	{
+		return static_cast<std::uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+
+	/**
+	 * @brief Code paths of InstanceGenerator, a later one needs a newer CPU.
+	 */
+	enum class SimdPath
+	{
+		Scalar,
+		SSE41,
+		AVX2
+	};
+
+	/**
+	 * @brief Writes the IconInstance records of icon rows, picking the widest SIMD path the CPU runs.
+	 *
+	 * The records are 3 words, so the vector paths convert the colors of several rows to RGBA8 at once,
+	 * interleave them with a vector of row numbers and the images and store them with full-width
+	 * writes: 4 rows per 3 SSE stores, 8 rows per 3 AVX stores. The path is chosen once at startup, the library does not
+	 * need to be built for AVX2.
+	 */
+	class InstanceGenerator
+	{
+	public:
+
+		/**
+		 * @brief Writes the records of the rows [first, first + count) with the active path.
+		 *
+		 * @param colors Color of each row, colors[0] belongs to row first.
+		 * @param images Image of each row, like colors.
+		 * @param out Room for count records.
+		 */
+		static void Generate(const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out);
+
+		/**
+		 * @brief Same as Generate with a given path, which must be supported.
+		 */
+		static void Generate(SimdPath path, const glm::vec4* colors, const std::uint32_t* images, unsigned int first, unsigned int count, IconInstance* out);
+
+		/**
+		 * @brief Widest path this CPU runs.
+		 */
+		static SimdPath Supported();
+
+		static SimdPath Active();
+
+		/**
+		 * @brief Makes Generate use a path, narrowed to Supported().
+		 */
+		static void SetActive(SimdPath path);
+
+		static const char* Name(SimdPath path);
+
+	}; // class InstanceGenerator
+
+} // namespace Vicetrice
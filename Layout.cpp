@@ -0,0 +1,204 @@
+#include "Layout.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Vicetrice
+{
+	static const float SizeTolerance = 1.0f / 256.0f; // pixels, a root moved by a float offset changes size by rounding only
+
+	static LayoutRect Inset(const LayoutRect& rect, const LayoutEdges& edges)
+	{
+		LayoutRect inset;
+		inset.left = rect.left + edges.left;
+		inset.top = rect.top + edges.top;
+		inset.right = std::max(inset.left, rect.right - edges.right);
+		inset.bottom = std::max(inset.top, rect.bottom - edges.bottom);
+		return inset;
+	}
+
+	static bool SameStyle(const LayoutStyle& a, const LayoutStyle& b)
+	{
+		return a.size.mode == b.size.mode && a.size.value == b.size.value && a.direction == b.direction &&
+			std::memcmp(&a.margin, &b.margin, sizeof(LayoutEdges)) == 0 &&
+			std::memcmp(&a.padding, &b.padding, sizeof(LayoutEdges)) == 0;
+	}
+
+
+	Layout::Layout()
+		: m_boxes{},
+		m_bounds{},
+		m_dirty{ true },
+		m_computations{ 0 },
+		m_arranged{ 0 }
+	{
+	}
+
+	unsigned int Layout::Add(unsigned int parent, const LayoutStyle& style)
+	{
+		unsigned int index = static_cast<unsigned int>(m_boxes.size());
+		m_boxes.push_back({ style, m_boxes.empty() ? None : parent, None, None, None, {}, {}, 0, true });
+
+		if (index != Root)
+		{
+			Box& owner = m_boxes[parent];
+			if (owner.LastChild == None)
+				owner.FirstChild = index;
+			else
+				m_boxes[owner.LastChild].NextSibling = index;
+			owner.LastChild = index;
+			owner.dirty = true;
+		}
+
+		m_dirty = true;
+		return index;
+	}
+
+	bool Layout::SetStyle(unsigned int box, const LayoutStyle& style)
+	{
+		if (SameStyle(m_boxes[box].style, style))
+			return false;
+
+		// Its size and margin place the siblings, its padding and direction its children
+		Box& changed = m_boxes[box];
+		changed.style = style;
+		changed.dirty = true;
+		if (changed.parent != None)
+			m_boxes[changed.parent].dirty = true;
+
+		m_dirty = true;
+		return true;
+	}
+
+	bool Layout::SetSize(unsigned int box, LayoutSize size)
+	{
+		LayoutStyle style = m_boxes[box].style;
+		style.size = size;
+		return SetStyle(box, style);
+	}
+
+	bool Layout::Update(const LayoutRect& bounds)
+	{
+		if (!m_dirty && bounds == m_bounds)
+			return false;
+
+		if (!m_dirty && std::abs(bounds.Width() - m_bounds.Width()) < SizeTolerance && std::abs(bounds.Height() - m_bounds.Height()) < SizeTolerance)
+		{
+			// The size of the last layout is kept, rounding does not add up over many moves
+			Translate(bounds.left - m_bounds.left, bounds.top - m_bounds.top);
+			return true;
+		}
+
+		m_bounds = bounds;
+		m_dirty = false;
+		++m_computations;
+
+		if (m_boxes.empty())
+			return true;
+
+		// The root fills the bounds, its margin is ignored
+		Place(m_boxes[Root], bounds);
+
+		// Parents come first, so each box is placed before its children are arranged in it, a clean box is skipped
+		for (Box& box : m_boxes)
+		{
+			if (!box.dirty)
+				continue;
+
+			Arrange(box);
+			box.dirty = false;
+			++m_arranged;
+		}
+
+		return true;
+	}
+
+	void Layout::Translate(float dx, float dy)
+	{
+		m_bounds.left += dx;
+		m_bounds.right += dx;
+		m_bounds.top += dy;
+		m_bounds.bottom += dy;
+
+		for (Box& box : m_boxes)
+		{
+			++box.version;
+			for (LayoutRect* rect : { &box.rect, &box.content })
+			{
+				rect->left += dx;
+				rect->right += dx;
+				rect->top += dy;
+				rect->bottom += dy;
+			}
+		}
+	}
+
+	void Layout::Arrange(const Box& box)
+	{
+		if (box.FirstChild == None)
+			return;
+
+		const LayoutRect& content = box.content;
+		const bool vertical = box.style.direction == LayoutDirection::Vertical;
+		const float available = vertical ? content.Height() : content.Width();
+
+		// What the fixed sizes and every margin along the axis leave goes to the flexible boxes
+		float fixed = 0.0f;
+		float weights = 0.0f;
+		for (unsigned int i = box.FirstChild; i != None; i = m_boxes[i].NextSibling)
+		{
+			const LayoutStyle& style = m_boxes[i].style;
+			fixed += vertical ? style.margin.top + style.margin.bottom : style.margin.left + style.margin.right;
+
+			if (style.size.mode == LayoutSize::Fixed)
+				fixed += style.size.value;
+			else
+				weights += style.size.value;
+		}
+
+		const float free = std::max(0.0f, available - fixed);
+		float cursor = vertical ? content.top : content.left;
+		const float end = vertical ? content.bottom : content.right;
+
+		for (unsigned int i = box.FirstChild; i != None; i = m_boxes[i].NextSibling)
+		{
+			Box& child = m_boxes[i];
+			const LayoutStyle& style = child.style;
+
+			float size = style.size.mode == LayoutSize::Fixed ? style.size.value : (weights > 0.0f ? free * style.size.value / weights : 0.0f);
+
+			LayoutRect rect;
+			if (vertical)
+			{
+				rect.top = std::min(cursor + style.margin.top, end);
+				rect.bottom = std::min(rect.top + size, end);
+				rect.left = content.left + style.margin.left;
+				rect.right = std::max(rect.left, content.right - style.margin.right);
+				cursor = rect.bottom + style.margin.bottom;
+			}
+			else
+			{
+				rect.left = std::min(cursor + style.margin.left, end);
+				rect.right = std::min(rect.left + size, end);
+				rect.top = content.top + style.margin.top;
+				rect.bottom = std::max(rect.top, content.bottom - style.margin.bottom);
+				cursor = rect.right + style.margin.right;
+			}
+
+			Place(child, rect);
+		}
+	}
+
+	void Layout::Place(Box& box, const LayoutRect& rect)
+	{
+		LayoutRect content = Inset(rect, box.style.padding);
+		if (rect == box.rect && content == box.content)
+			return;
+
+		box.rect = rect;
+		box.content = content;
+		++box.version;
+		box.dirty = true;
+	}
+
+} // namespace Vicetrice
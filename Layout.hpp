@@ -0,0 +1,201 @@
+#pragma once
+
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Rectangle in pixels of the context, y grows downwards like the cursor positions.
+	 */
+	struct LayoutRect
+	{
+		float left = 0.0f;
+		float top = 0.0f;
+		float right = 0.0f;
+		float bottom = 0.0f;
+
+		inline float Width() const { return right - left; }
+		inline float Height() const { return bottom - top; }
+
+		inline bool Contains(float x, float y) const
+		{
+			return x >= left && x <= right && y >= top && y <= bottom;
+		}
+
+		inline bool operator==(const LayoutRect& other) const
+		{
+			return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+		}
+
+		inline bool operator!=(const LayoutRect& other) const { return !(*this == other); }
+	};
+
+	/**
+	 * @brief Thickness of each side of a margin or a padding, in pixels.
+	 */
+	struct LayoutEdges
+	{
+		float left = 0.0f;
+		float top = 0.0f;
+		float right = 0.0f;
+		float bottom = 0.0f;
+	};
+
+	/**
+	 * @brief Size of a box along the direction its parent stacks the children in.
+	 */
+	struct LayoutSize
+	{
+		enum Mode : unsigned char
+		{
+			Fixed, /// value is pixels.
+			Flex   /// value is a weight, the space the fixed boxes leave is shared by weight.
+		};
+
+		Mode mode = Flex;
+		float value = 1.0f;
+
+		static inline LayoutSize Pixels(float pixels) { return { Fixed, pixels }; }
+		static inline LayoutSize Weight(float weight = 1.0f) { return { Flex, weight }; }
+	};
+
+	/**
+	 * @brief How a box stacks its children, the other axis is filled.
+	 */
+	enum class LayoutDirection : unsigned char
+	{
+		Vertical,
+		Horizontal
+	};
+
+	/**
+	 * @brief Everything the layout of a box depends on.
+	 */
+	struct LayoutStyle
+	{
+		LayoutSize size;          /// Size of the border box along the direction of the parent.
+		LayoutEdges margin;       /// Space around the box, not part of its rectangle.
+		LayoutEdges padding;      /// Space between the rectangle of the box and its children.
+		LayoutDirection direction = LayoutDirection::Vertical;
+	};
+
+	/**
+	 * @brief Box model layout of a small tree of boxes, in pixels.
+	 *
+	 * Each box has a margin, a padding and a size that is either fixed or a share of the space left by
+	 * its fixed siblings. The children of a box are stacked vertically or horizontally in its content
+	 * box and stretched over the other axis. Sizes that do not fit shrink to 0, never below.
+	 *
+	 * The rectangles are computed in one pass over the boxes, in the order they were added, and kept
+	 * until a style or the rectangle of the root changes, so reading them costs nothing. Only the boxes
+	 * whose style changed and the ones whose rectangle moved because of it are arranged again, the
+	 * rest of the tree is skipped. A root that only moved, or changed size by less than float rounding,
+	 * moves the cached rectangles with it.
+	 */
+	class Layout
+	{
+	public:
+
+		/**
+		 * @brief Box returned by Add for the root, which is always the first one.
+		 */
+		static const unsigned int Root = 0;
+
+		Layout();
+
+		/**
+		 * @brief Adds a box as the last child of another one, the first box added is the root.
+		 *
+		 * @param parent Box the new one is stacked in, ignored for the root.
+		 * @return Handle of the box, its index in the order of addition.
+		 */
+		unsigned int Add(unsigned int parent, const LayoutStyle& style);
+
+		inline const LayoutStyle& Style(unsigned int box) const { return m_boxes[box].style; }
+
+		/**
+		 * @brief Changes the style of a box, the next Update arranges it and its siblings again if it differs.
+		 *
+		 * @return True if the style differs.
+		 */
+		bool SetStyle(unsigned int box, const LayoutStyle& style);
+
+		/**
+		 * @brief Changes the size of a box along the direction of its parent.
+		 *
+		 * @return True if the size differs.
+		 */
+		bool SetSize(unsigned int box, LayoutSize size);
+
+		/**
+		 * @brief Lays the tree out in a rectangle, the border box of the root.
+		 *
+		 * @return True if the rectangles were computed again or moved, false if the cached ones were still valid.
+		 */
+		bool Update(const LayoutRect& bounds);
+
+		/**
+		 * @brief Changes every time the rectangle or the content box of a box changes.
+		 */
+		inline unsigned long long Version(unsigned int box) const { return m_boxes[box].version; }
+
+		/**
+		 * @brief Border box of a box at the last Update.
+		 */
+		inline const LayoutRect& Rect(unsigned int box) const { return m_boxes[box].rect; }
+
+		/**
+		 * @brief Content box (border box minus padding) of a box at the last Update.
+		 */
+		inline const LayoutRect& Content(unsigned int box) const { return m_boxes[box].content; }
+
+		/**
+		 * @brief Times the tree was laid out, moves of the whole tree are not counted.
+		 */
+		inline unsigned long long Computations() const { return m_computations; }
+
+		/**
+		 * @brief Boxes whose children were arranged, over every Update.
+		 */
+		inline unsigned long long Arranged() const { return m_arranged; }
+
+	private:
+		static const unsigned int None = ~0u;
+
+		struct Box
+		{
+			LayoutStyle style;
+			unsigned int parent;
+			unsigned int FirstChild;
+			unsigned int LastChild;
+			unsigned int NextSibling;
+			LayoutRect rect;          /// Border box.
+			LayoutRect content;       /// Border box minus the padding.
+			unsigned long long version;
+			bool dirty;               /// The children must be arranged again.
+		};
+
+		std::vector<Box> m_boxes;     /// Parents always come before their children.
+		LayoutRect m_bounds;          /// Rectangle of the root at the last Update.
+		bool m_dirty;                 /// A style changed since the last Update.
+		unsigned long long m_computations;
+		unsigned long long m_arranged;
+
+		/**
+		 * @brief Moves every rectangle, for a root that moved without changing size.
+		 */
+		void Translate(float dx, float dy);
+
+		/**
+		 * @brief Places the children of a box in its content box, the ones that moved are marked dirty.
+		 */
+		void Arrange(const Box& box);
+
+		/**
+		 * @brief Sets the rectangle of a box, its version changes and its children are marked dirty if it differs.
+		 */
+		void Place(Box& box, const LayoutRect& rect);
+
+	}; // class Layout
+
+} // namespace Vicetrice
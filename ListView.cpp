@@ -0,0 +1,228 @@
+#include "ListView.hpp"
+#include "Font.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Vicetrice
+{
+	static const unsigned int NoSlotRow = ~0u;         // Slot of the ring that holds no row
+	static const float LabelSpacing = 6.0f;            // pixels between the image square and the label
+
+
+	ListView::ListView(WidgetTree& tree, Widget* parent, const LayoutStyle& style, IconSource* source, float RowHeight)
+		: Widget{ tree, parent, style },
+		m_source{ source },
+		m_RowHeight{ RowHeight },
+		m_RowCount{ 0 },
+		m_FullRows{ 0 },
+		m_MaxRows{ 1 },
+		m_first{ 0 },
+		m_ShownFirst{ 0 },
+		m_ShownCount{ 0 },
+		m_revision{ 0 },
+		m_font{ nullptr },
+		m_LabelColor{ 0.0f },
+		m_slots{},
+		m_SlotRows{},
+		m_capacity{ 0 },
+		m_SlotsChanged{ false }
+	{
+	}
+
+	void ListView::SetSource(IconSource* source)
+	{
+		m_source = source;
+		m_first = 0;
+		RowsChanged(0);
+	}
+
+	void ListView::SetFont(Font* font, const glm::vec4& color)
+	{
+		m_font = font;
+		m_LabelColor = color;
+		Invalidate();
+	}
+
+	void ListView::RowsChanged(unsigned int FirstChangedRow)
+	{
+		for (unsigned int& row : m_SlotRows)
+		{
+			if (row != NoSlotRow && row >= FirstChangedRow)
+				row = NoSlotRow;
+		}
+	}
+
+	void ListView::Fit()
+	{
+		m_RowCount = m_source->Count();
+
+		// The ring grows with the widget, so there is no upper limit on the visible rows
+		float height = Rect().Height();
+		m_FullRows = static_cast<unsigned int>(std::floor(height / m_RowHeight));
+		m_MaxRows = std::max(1u, static_cast<unsigned int>(std::ceil(height / m_RowHeight)));
+	}
+
+	void ListView::ScrollTo(unsigned int first)
+	{
+		VICE_PROFILE_ZONE("ListView::ScrollTo");
+
+		m_first = first;
+
+		if (m_RowCount != 0)
+		{
+			Reserve(m_MaxRows);
+			Materialize();
+		}
+
+		unsigned int shown, count;
+		VisibleRows(shown, count);
+
+		if (!m_SlotsChanged && shown == m_ShownFirst && count == m_ShownCount)
+			return;
+
+		m_ShownFirst = shown;
+		m_ShownCount = count;
+		m_SlotsChanged = false;
+		++m_revision;
+		Invalidate();
+	}
+
+	unsigned int ListView::RowAt(float x, float y) const
+	{
+		// Rows are clipped to the widget, row i of the shown ones is RowRect(i)
+		if (!Rect().Contains(x, y))
+			return NoRow;
+
+		float row = std::floor((y - Rect().top) / m_RowHeight);
+		if (row < 0.0f || row >= static_cast<float>(m_ShownCount))
+			return NoRow;
+
+		return m_ShownFirst + static_cast<unsigned int>(row);
+	}
+
+	LayoutRect ListView::RowRect(unsigned int n) const
+	{
+		float top = Rect().top + m_RowHeight * static_cast<float>(n);
+
+		return { Rect().left, top, Rect().right, top + m_RowHeight };
+	}
+
+	LayoutRect ListView::ImageRect(const LayoutRect& row) const
+	{
+		return { row.left, row.top, std::min(row.left + m_RowHeight, row.right), row.bottom };
+	}
+
+	glm::vec2 ListView::LabelOrigin(const LayoutRect& row) const
+	{
+		// On whole pixels, as the glyphs were rasterized
+		float height = m_font->Ascent() - m_font->Descent();
+		float baseline = row.top + std::floor((m_RowHeight - height) * 0.5f + m_font->Ascent() + 0.5f);
+
+		return glm::vec2(std::floor(row.left) + m_RowHeight + LabelSpacing, baseline);
+	}
+
+	void ListView::Tessellate(std::vector<float>& batch) const
+	{
+		for (unsigned int i = 0; i < m_ShownCount; i++)
+		{
+			const IconInstance& slot = m_slots[(m_ShownFirst + i) % m_capacity];
+			glm::vec4 color(slot.color[0] / 255.0f, slot.color[1] / 255.0f, slot.color[2] / 255.0f, slot.color[3] / 255.0f);
+
+			LayoutRect row = RowRect(i);
+			m_tree.AddRect(batch, row, color, Rect());
+
+			// The image over the square at the start of the row, as the icon shader draws it
+			if (slot.image != TextureAtlas::NoImage)
+				m_tree.AddRect(batch, ImageRect(row), glm::vec4(1.0f), Rect(), slot.image);
+
+			if (m_font == nullptr)
+				continue;
+
+			// Laid out once per string, the glyphs of the run only move to the row
+			const TextRun& run = m_font->Shape(m_source->Label(m_ShownFirst + i));
+			glm::vec2 origin = LabelOrigin(row);
+
+			for (const TextRun::Quad& quad : run.quads)
+			{
+				LayoutRect glyph = { origin.x + quad.rect.left, origin.y + quad.rect.top, origin.x + quad.rect.right, origin.y + quad.rect.bottom };
+				m_tree.AddRect(batch, glyph, m_LabelColor, Rect(), quad.image);
+			}
+		}
+	}
+
+	void ListView::Reserve(unsigned int capacity)
+	{
+		if (capacity <= m_capacity)
+			return;
+
+		unsigned int NewCapacity = m_capacity == 0 ? capacity : m_capacity;
+		while (NewCapacity < capacity)
+			NewCapacity *= 2;
+
+		m_slots.resize(NewCapacity);
+		m_capacity = NewCapacity;
+
+		// row % capacity changed for every row
+		m_SlotRows.assign(NewCapacity, NoSlotRow);
+		m_SlotsChanged = true;
+	}
+
+	void ListView::Materialize()
+	{
+		VICE_PROFILE_ZONE("ListView::Materialize");
+
+		unsigned int first, count;
+		VisibleRows(first, count);
+
+		// Consecutive missing rows are fetched with a single call, scrolling by n rows fetches n rows
+		unsigned int end = first + count;
+		unsigned int row = first;
+
+		while (row < end)
+		{
+			if (m_SlotRows[row % m_capacity] == row)
+			{
+				++row;
+				continue;
+			}
+
+			unsigned int missing = row + 1;
+			while (missing < end && m_SlotRows[missing % m_capacity] != missing)
+				++missing;
+
+			WriteSlots(row, missing - row);
+
+			row = missing;
+		}
+	}
+
+	void ListView::WriteSlots(unsigned int row, unsigned int count)
+	{
+		// The rows fill at most two runs of slots, one up to the end of the ring and one from its start
+		while (count != 0)
+		{
+			unsigned int slot = row % m_capacity;
+			unsigned int run = count < m_capacity - slot ? count : m_capacity - slot;
+
+			unsigned int written = m_source->WriteInstances(row, run, &m_slots[slot]);
+			for (unsigned int i = 0; i < written; ++i)
+				m_SlotRows[slot + i] = row + i;
+
+			if (written != 0)
+				m_SlotsChanged = true;
+			if (written < run)
+				return;
+
+			row += run;
+			count -= run;
+		}
+	}
+
+	void ListView::VisibleRows(unsigned int& first, unsigned int& count) const
+	{
+		first = m_first < m_RowCount ? m_first : m_RowCount;
+		count = (m_RowCount - first) > m_MaxRows ? m_MaxRows : m_RowCount - first;
+	}
+
+} // namespace Vicetrice
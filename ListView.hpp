@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include "Widget.hpp"
+#include "IconSource.hpp"
+#include "InstanceGenerator.hpp"
+
+namespace Vicetrice
+{
+	class Font;
+
+	/**
+	 * @brief Widget showing the rows of an IconSource stacked at a fixed height.
+	 *
+	 * Only the visible rows are fetched from the source, into a ring of IconInstance slots indexed by
+	 * row % capacity, so scrolling by n rows fetches n rows. The rows shown change only with ScrollTo,
+	 * RowsChanged or a new source, and each change bumps Revision so the owner knows when to upload.
+	 * A row with an image shows it in ImageRect, over the color of the row, and its label follows in
+	 * the font of the list. The label is read and laid out only when the row is tessellated, and
+	 * its glyphs are rectangles of the same batch as the rows.
+	 */
+	class ListView : public Widget
+	{
+	public:
+
+		/**
+		 * @brief Returned by RowAt when no row is under the position.
+		 */
+		static const unsigned int NoRow = ~0u;
+
+		/**
+		 * @param source Source of the rows, not owned.
+		 * @param RowHeight Height of each row in pixels.
+		 */
+		ListView(WidgetTree& tree, Widget* parent, const LayoutStyle& style, IconSource* source, float RowHeight);
+
+		/**
+		 * @brief Shows the rows of another source from the first one, every slot is fetched again.
+		 */
+		void SetSource(IconSource* source);
+
+		inline IconSource* Source() const { return m_source; }
+
+		/**
+		 * @brief Sets the font the labels of the rows are drawn with.
+		 *
+		 * @param font Not owned, its glyphs must be in the atlas the batch is drawn with. nullptr draws no label.
+		 */
+		void SetFont(Font* font, const glm::vec4& color);
+
+		inline Font* GetFont() const { return m_font; }
+
+		/**
+		 * @brief Forgets the slots of the rows from FirstChangedRow on, they are fetched again at the next ScrollTo.
+		 */
+		void RowsChanged(unsigned int FirstChangedRow);
+
+		/**
+		 * @brief Counts the rows of the source and the rows that fit in Rect().
+		 */
+		void Fit();
+
+		/**
+		 * @brief Shows the rows from first on, fetching the ones missing from the ring.
+		 */
+		void ScrollTo(unsigned int first);
+
+		/**
+		 * @brief Rows of the source at the last Fit.
+		 */
+		inline unsigned int RowCount() const { return m_RowCount; }
+
+		/**
+		 * @brief Rows that fit whole in Rect().
+		 */
+		inline unsigned int FullRows() const { return m_FullRows; }
+
+		/**
+		 * @brief Rows that fit in Rect() counting a partial last one, the most that are shown.
+		 */
+		inline unsigned int MaxRows() const { return m_MaxRows; }
+
+		/**
+		 * @brief First row shown.
+		 */
+		inline unsigned int First() const { return m_ShownFirst; }
+
+		/**
+		 * @brief Number of rows shown.
+		 */
+		inline unsigned int Shown() const { return m_ShownCount; }
+
+		/**
+		 * @brief Changes every time the rows shown or their slots change.
+		 */
+		inline unsigned long long Revision() const { return m_revision; }
+
+		inline float RowHeight() const { return m_RowHeight; }
+
+		/**
+		 * @brief Slots of the ring, row r is in slot r % Capacity() when it was fetched.
+		 */
+		inline const IconInstance* Slots() const { return m_slots.data(); }
+
+		inline unsigned int Capacity() const { return m_capacity; }
+
+		/**
+		 * @brief Index in the source of the row shown under a position, NoRow if there is none.
+		 */
+		unsigned int RowAt(float x, float y) const;
+
+		/**
+		 * @brief Rectangle of the n-th row shown, it may reach below Rect().
+		 */
+		LayoutRect RowRect(unsigned int n) const;
+
+		/**
+		 * @brief Square at the start of a row where its image is drawn, as wide as the row is high.
+		 */
+		LayoutRect ImageRect(const LayoutRect& row) const;
+
+		/**
+		 * @brief Start of the baseline of the label of a row, after ImageRect and centered vertically.
+		 */
+		glm::vec2 LabelOrigin(const LayoutRect& row) const;
+
+	protected:
+		void Tessellate(std::vector<float>& batch) const override;
+
+	private:
+		IconSource* m_source;
+		float m_RowHeight;
+		unsigned int m_RowCount;
+		unsigned int m_FullRows;
+		unsigned int m_MaxRows;
+		unsigned int m_first;          /// First row asked by ScrollTo.
+		unsigned int m_ShownFirst;
+		unsigned int m_ShownCount;
+		unsigned long long m_revision;
+		Font* m_font;                  /// Font of the labels, not owned.
+		glm::vec4 m_LabelColor;
+
+		std::vector<IconInstance> m_slots; /// Instance data of the rows fetched so far, a ring indexed by row % capacity.
+		std::vector<unsigned int> m_SlotRows; /// Row held by each slot of the ring.
+		unsigned int m_capacity;
+		bool m_SlotsChanged;           /// A slot was written since the rows shown last changed.
+
+		/**
+		 * @brief Grows the ring to hold at least the given number of rows.
+		 *
+		 * Growth is geometric. The ring is remapped and every row is fetched again.
+		 */
+		void Reserve(unsigned int capacity);
+
+		/**
+		 * @brief Fetches the visible rows that are not in the ring yet and writes them into their slots.
+		 */
+		void Materialize();
+
+		/**
+		 * @brief Writes consecutive rows into their slots of the ring, with one call to the source per contiguous run of slots.
+		 */
+		void WriteSlots(unsigned int row, unsigned int count);
+
+		/**
+		 * @brief Computes the range of rows that are shown from m_first.
+		 */
+		void VisibleRows(unsigned int& first, unsigned int& count) const;
+
+	}; // class ListView
+
+} // namespace Vicetrice
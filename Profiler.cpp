@@ -0,0 +1,165 @@
+#include "Profiler.hpp"
+
+#ifdef VICE_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+namespace Vicetrice
+{
+	static const char* const CounterNames[] =
+	{
+		"instances_uploaded",
+		"buffer_bytes",
+		"draw_calls",
+		"events_processed",
+		"damaged_pixels"
+	};
+
+	static_assert(sizeof(CounterNames) / sizeof(CounterNames[0]) == static_cast<size_t>(ProfileCounter::Count), "Missing counter name");
+
+	static const size_t CounterCount = static_cast<size_t>(ProfileCounter::Count);
+	static const uint64_t RingSize = 1 << 14;   // Power of two
+
+	struct ProfileEvent
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t duration;
+		uint64_t values[CounterCount];   // Only used by frame events
+		uint32_t thread;
+		bool frame;
+	};
+
+	/**
+	 * Slots are written like a seqlock: the sequence is odd while the event is being written
+	 * and 2 * (index + 1) once it is complete, so the reader can skip torn or lapped slots.
+	 */
+	struct ProfileSlot
+	{
+		std::atomic<uint64_t> sequence{ 0 };
+		ProfileEvent event;
+	};
+
+	static ProfileSlot s_ring[RingSize];
+	static std::atomic<uint64_t> s_head{ 0 };
+	static std::atomic<uint64_t> s_counters[CounterCount];
+	static std::atomic<uint32_t> s_threads{ 0 };
+
+	static uint32_t ThreadIndex()
+	{
+		thread_local uint32_t index = s_threads.fetch_add(1, std::memory_order_relaxed);
+		return index;
+	}
+
+	static void Push(const ProfileEvent& event)
+	{
+		uint64_t index = s_head.fetch_add(1, std::memory_order_relaxed);
+		ProfileSlot& slot = s_ring[index & (RingSize - 1)];
+
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.event = event;
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+	}
+
+	uint64_t Profiler::Now()
+	{
+		static const auto epoch = std::chrono::steady_clock::now();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+	}
+
+	void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+	{
+		ProfileEvent event{};
+		event.name = name;
+		event.start = start;
+		event.duration = end - start;
+		event.thread = ThreadIndex();
+		event.frame = false;
+		Push(event);
+	}
+
+	void Profiler::Count(ProfileCounter counter, uint64_t value)
+	{
+		s_counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	void Profiler::EndFrame()
+	{
+		ProfileEvent event{};
+		event.name = "frame";
+		event.start = Now();
+		event.thread = ThreadIndex();
+		event.frame = true;
+
+		for (size_t i = 0; i < CounterCount; ++i)
+		{
+			event.values[i] = s_counters[i].exchange(0, std::memory_order_relaxed);
+		}
+
+		Push(event);
+	}
+
+	bool Profiler::WriteChromeTrace(const std::string& path)
+	{
+		std::ofstream stream(path);
+		if (!stream)
+			return false;
+
+		uint64_t head = s_head.load(std::memory_order_acquire);
+		uint64_t first = head > RingSize ? head - RingSize : 0;
+
+		std::vector<ProfileEvent> events;
+		events.reserve(static_cast<size_t>(head - first));
+
+		for (uint64_t index = first; index < head; ++index)
+		{
+			const ProfileSlot& slot = s_ring[index & (RingSize - 1)];
+
+			uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			if (sequence != 2 * index + 2)
+				continue;
+
+			ProfileEvent event = slot.event;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+				events.push_back(event);
+		}
+
+		// Chrome trace timestamps are in microseconds
+		stream << std::fixed << std::setprecision(3);
+		stream << "{\"traceEvents\":[\n";
+		for (size_t i = 0; i < events.size(); ++i)
+		{
+			const ProfileEvent& event = events[i];
+
+			stream << (i == 0 ? "" : ",\n");
+			if (event.frame)
+			{
+				stream << "{\"name\":\"frame\",\"ph\":\"C\",\"pid\":0,\"tid\":" << event.thread
+					<< ",\"ts\":" << event.start / 1000.0 << ",\"args\":{";
+				for (size_t c = 0; c < CounterCount; ++c)
+				{
+					stream << (c == 0 ? "" : ",") << '"' << CounterNames[c] << "\":" << event.values[c];
+				}
+				stream << "}}";
+			}
+			else
+			{
+				stream << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+					<< ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0 << '}';
+			}
+		}
+		stream << "\n]}\n";
+
+		return static_cast<bool>(stream);
+	}
+
+} // namespace Vicetrice
+
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * Instrumentation layer, compiled in with VICE_PROFILE defined and reduced to nothing otherwise.
+ *
+ *	VICE_PROFILE_ZONE("name")          times the enclosing scope
+ *	VICE_PROFILE_COUNT(counter, value) adds value to a per-frame counter (see ProfileCounter)
+ *	VICE_PROFILE_FRAME()               closes the frame, records the counters and resets them
+ *	VICE_PROFILE_DUMP("trace.json")    writes the recorded events as a Chrome trace (chrome://tracing, Perfetto)
+ *
+ * Names must be string literals, only the pointer is stored.
+ */
+
+#ifdef VICE_PROFILE
+
+#include <cstdint>
+#include <string>
+
+#define VICE_PROFILE_CONCAT_(a, b) a##b
+#define VICE_PROFILE_CONCAT(a, b) VICE_PROFILE_CONCAT_(a, b)
+
+#define VICE_PROFILE_ZONE(name) ::Vicetrice::ProfileZone VICE_PROFILE_CONCAT(profileZone, __LINE__){ name }
+#define VICE_PROFILE_COUNT(counter, value) ::Vicetrice::Profiler::Count(::Vicetrice::ProfileCounter::counter, static_cast<uint64_t>(value))
+#define VICE_PROFILE_FRAME() ::Vicetrice::Profiler::EndFrame()
+#define VICE_PROFILE_DUMP(path) ::Vicetrice::Profiler::WriteChromeTrace(path)
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Counters accumulated during a frame.
+	 */
+	enum class ProfileCounter
+	{
+		InstancesUploaded,  /// Per-instance records sent to instance buffers
+		BufferBytes,        /// Bytes sent with glBufferData/glBufferSubData
+		DrawCalls,          /// Draw calls issued
+		EventsProcessed,    /// Input events handled
+		DamagedPixels,      /// Pixels redrawn because they were damaged
+		Count
+	};
+
+	/**
+	 * @brief Records zones and counters into a lock-free ring buffer shared by all threads.
+	 *
+	 * When the ring is full the oldest events are overwritten.
+	 */
+	class Profiler
+	{
+	public:
+
+		/**
+		 * @brief Nanoseconds since the first call.
+		 */
+		static uint64_t Now();
+
+		/**
+		 * @brief Records a finished zone.
+		 *
+		 * @param name Name of the zone.
+		 * @param start Start time returned by Now.
+		 * @param end End time returned by Now.
+		 */
+		static void Record(const char* name, uint64_t start, uint64_t end);
+
+		/**
+		 * @brief Adds a value to a counter of the current frame.
+		 */
+		static void Count(ProfileCounter counter, uint64_t value);
+
+		/**
+		 * @brief Records the counters of the current frame and resets them.
+		 */
+		static void EndFrame();
+
+		/**
+		 * @brief Writes the events still in the ring as Chrome trace JSON.
+		 *
+		 * @param path File to write.
+		 * @return True if the file could be written.
+		 */
+		static bool WriteChromeTrace(const std::string& path);
+	}; // class Profiler
+
+	/**
+	 * @brief Times the scope it lives in.
+	 */
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) : m_name{ name }, m_start{ Profiler::Now() } {}
+		~ProfileZone() { Profiler::Record(m_name, m_start, Profiler::Now()); }
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	private:
+		const char* m_name;
+		uint64_t m_start;
+	}; // class ProfileZone
+
+} // namespace Vicetrice
+
+#else
+
+#define VICE_PROFILE_ZONE(name) ((void)0)
+#define VICE_PROFILE_COUNT(counter, value) ((void)0)
+#define VICE_PROFILE_FRAME() ((void)0)
+#define VICE_PROFILE_DUMP(path) ((void)0)
+
+#endif
@@ -0,0 +1,576 @@
+#include "RecordingBackend.hpp"
+#include <GL/glew.h>
+
+namespace Vicetrice
+{
+	RecordingBackend::RecordingBackend(Backend* forward, bool KeepCommands)
+		: m_forward{ forward },
+		m_KeepCommands{ KeepCommands },
+		m_commands{},
+		m_stats{},
+		m_NextName{ 1 },
+		m_locations{}
+	{
+	}
+
+	/**
+	 * @brief Bytes of one pixel of 8-bit channels in a given format.
+	 */
+	static unsigned int PixelBytes(unsigned int format)
+	{
+		switch (format)
+		{
+		case GL_RED:
+			return 1;
+		case GL_RG:
+			return 2;
+		case GL_RGB:
+			return 3;
+		default:
+			return 4;
+		}
+	}
+
+	void RecordingBackend::Reset()
+	{
+		m_commands.clear();
+		m_stats = BackendStats{};
+	}
+
+	void RecordingBackend::Record(CommandType type, unsigned int target, unsigned int object, unsigned int offset, unsigned int size, unsigned int instances)
+	{
+		++m_stats.Commands;
+		if (m_KeepCommands)
+			m_commands.push_back({ type, target, object, offset, size, instances });
+	}
+
+	unsigned int RecordingBackend::NextName()
+	{
+		return m_NextName++;
+	}
+
+
+	unsigned int RecordingBackend::GenBuffer()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->GenBuffer() : NextName();
+	}
+
+	void RecordingBackend::DeleteBuffer(unsigned int buffer)
+	{
+		Record(CommandType::Other, 0, buffer);
+		if (m_forward != nullptr)
+			m_forward->DeleteBuffer(buffer);
+	}
+
+	void RecordingBackend::BindBuffer(unsigned int target, unsigned int buffer)
+	{
+		Record(CommandType::BindBuffer, target, buffer);
+		++m_stats.Binds;
+		if (m_forward != nullptr)
+			m_forward->BindBuffer(target, buffer);
+	}
+
+	void RecordingBackend::BufferData(unsigned int target, unsigned int size, const void* data, unsigned int usage)
+	{
+		Record(CommandType::BufferData, target, 0, 0, size);
+		++m_stats.Allocations;
+		if (data != nullptr)
+		{
+			++m_stats.Uploads;
+			m_stats.BytesUploaded += size;
+		}
+		if (m_forward != nullptr)
+			m_forward->BufferData(target, size, data, usage);
+	}
+
+	void RecordingBackend::BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data)
+	{
+		Record(CommandType::BufferSubData, target, 0, offset, size);
+		++m_stats.Uploads;
+		m_stats.BytesUploaded += size;
+		if (m_forward != nullptr)
+			m_forward->BufferSubData(target, offset, size, data);
+	}
+
+	void RecordingBackend::BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size)
+	{
+		Record(CommandType::BindBuffer, target, buffer, offset, size);
+		++m_stats.Binds;
+		if (m_forward != nullptr)
+			m_forward->BindBufferRange(target, index, buffer, offset, size);
+	}
+
+
+	bool RecordingBackend::BufferStorage(unsigned int target, unsigned int size, unsigned int flags)
+	{
+		Record(CommandType::BufferData, target, 0, 0, size);
+		++m_stats.Allocations;
+		return m_forward != nullptr ? m_forward->BufferStorage(target, size, flags) : false;
+	}
+
+	void* RecordingBackend::MapBufferRange(unsigned int target, unsigned int offset, unsigned int size, unsigned int access)
+	{
+		Record(CommandType::Other, target, 0, offset, size);
+		return m_forward != nullptr ? m_forward->MapBufferRange(target, offset, size, access) : nullptr;
+	}
+
+	void RecordingBackend::FlushMappedBufferRange(unsigned int target, unsigned int offset, unsigned int size)
+	{
+		//The writes to mapped memory are not seen, the flushed ranges are what reaches the buffer
+		Record(CommandType::FlushMappedBufferRange, target, 0, offset, size);
+		++m_stats.Uploads;
+		m_stats.BytesUploaded += size;
+		if (m_forward != nullptr)
+			m_forward->FlushMappedBufferRange(target, offset, size);
+	}
+
+	void RecordingBackend::UnmapBuffer(unsigned int target)
+	{
+		Record(CommandType::Other, target);
+		if (m_forward != nullptr)
+			m_forward->UnmapBuffer(target);
+	}
+
+	void* RecordingBackend::FenceSync()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->FenceSync() : nullptr;
+	}
+
+	void RecordingBackend::ClientWaitSync(void* fence)
+	{
+		Record(CommandType::Other);
+		if (m_forward != nullptr)
+			m_forward->ClientWaitSync(fence);
+	}
+
+	void RecordingBackend::DeleteSync(void* fence)
+	{
+		Record(CommandType::Other);
+		if (m_forward != nullptr)
+			m_forward->DeleteSync(fence);
+	}
+
+
+	unsigned int RecordingBackend::GenVertexArray()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->GenVertexArray() : NextName();
+	}
+
+	void RecordingBackend::DeleteVertexArray(unsigned int array)
+	{
+		Record(CommandType::Other, 0, array);
+		if (m_forward != nullptr)
+			m_forward->DeleteVertexArray(array);
+	}
+
+	void RecordingBackend::BindVertexArray(unsigned int array)
+	{
+		Record(CommandType::BindVertexArray, 0, array);
+		++m_stats.Binds;
+		if (m_forward != nullptr)
+			m_forward->BindVertexArray(array);
+	}
+
+	void RecordingBackend::EnableVertexAttribArray(unsigned int index)
+	{
+		Record(CommandType::Other, 0, index);
+		if (m_forward != nullptr)
+			m_forward->EnableVertexAttribArray(index);
+	}
+
+	void RecordingBackend::VertexAttribPointer(unsigned int index, int count, unsigned int type, bool normalized, int stride, unsigned int offset)
+	{
+		Record(CommandType::VertexAttribPointer, type, index, offset, static_cast<unsigned int>(stride));
+		if (m_forward != nullptr)
+			m_forward->VertexAttribPointer(index, count, type, normalized, stride, offset);
+	}
+
+	void RecordingBackend::VertexAttribIPointer(unsigned int index, int count, unsigned int type, int stride, unsigned int offset)
+	{
+		Record(CommandType::VertexAttribPointer, type, index, offset, static_cast<unsigned int>(stride));
+		if (m_forward != nullptr)
+			m_forward->VertexAttribIPointer(index, count, type, stride, offset);
+	}
+
+	void RecordingBackend::VertexAttribDivisor(unsigned int index, unsigned int divisor)
+	{
+		Record(CommandType::Other, 0, index);
+		if (m_forward != nullptr)
+			m_forward->VertexAttribDivisor(index, divisor);
+	}
+
+
+	unsigned int RecordingBackend::CreateShader(unsigned int type)
+	{
+		Record(CommandType::Other, type);
+		return m_forward != nullptr ? m_forward->CreateShader(type) : NextName();
+	}
+
+	void RecordingBackend::ShaderSource(unsigned int shader, const char* source)
+	{
+		Record(CommandType::Other, 0, shader);
+		if (m_forward != nullptr)
+			m_forward->ShaderSource(shader, source);
+	}
+
+	void RecordingBackend::CompileShader(unsigned int shader)
+	{
+		Record(CommandType::Other, 0, shader);
+		if (m_forward != nullptr)
+			m_forward->CompileShader(shader);
+	}
+
+	int RecordingBackend::GetShaderiv(unsigned int shader, unsigned int pname)
+	{
+		if (m_forward != nullptr)
+			return m_forward->GetShaderiv(shader, pname);
+
+		return pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+	}
+
+	void RecordingBackend::GetShaderInfoLog(unsigned int shader, int size, char* log)
+	{
+		if (m_forward != nullptr)
+			m_forward->GetShaderInfoLog(shader, size, log);
+		else if (size > 0)
+			log[0] = '\0';
+	}
+
+	void RecordingBackend::DeleteShader(unsigned int shader)
+	{
+		Record(CommandType::Other, 0, shader);
+		if (m_forward != nullptr)
+			m_forward->DeleteShader(shader);
+	}
+
+	unsigned int RecordingBackend::CreateProgram()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->CreateProgram() : NextName();
+	}
+
+	void RecordingBackend::AttachShader(unsigned int program, unsigned int shader)
+	{
+		Record(CommandType::Other, 0, program);
+		if (m_forward != nullptr)
+			m_forward->AttachShader(program, shader);
+	}
+
+	void RecordingBackend::LinkProgram(unsigned int program)
+	{
+		Record(CommandType::Other, 0, program);
+		if (m_forward != nullptr)
+			m_forward->LinkProgram(program);
+	}
+
+	void RecordingBackend::ValidateProgram(unsigned int program)
+	{
+		Record(CommandType::Other, 0, program);
+		if (m_forward != nullptr)
+			m_forward->ValidateProgram(program);
+	}
+
+	int RecordingBackend::GetProgramiv(unsigned int program, unsigned int pname)
+	{
+		if (m_forward != nullptr)
+			return m_forward->GetProgramiv(program, pname);
+
+		return (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+	}
+
+	void RecordingBackend::GetProgramInfoLog(unsigned int program, int size, char* log)
+	{
+		if (m_forward != nullptr)
+			m_forward->GetProgramInfoLog(program, size, log);
+		else if (size > 0)
+			log[0] = '\0';
+	}
+
+	void RecordingBackend::DeleteProgram(unsigned int program)
+	{
+		Record(CommandType::Other, 0, program);
+		if (m_forward != nullptr)
+			m_forward->DeleteProgram(program);
+	}
+
+	void RecordingBackend::UseProgram(unsigned int program)
+	{
+		Record(CommandType::UseProgram, 0, program);
+		++m_stats.Binds;
+		if (m_forward != nullptr)
+			m_forward->UseProgram(program);
+	}
+
+
+	void RecordingBackend::ProgramBinaryRetrievable(unsigned int program)
+	{
+		Record(CommandType::Other, 0, program);
+		if (m_forward != nullptr)
+			m_forward->ProgramBinaryRetrievable(program);
+	}
+
+	bool RecordingBackend::GetProgramBinary(unsigned int program, std::vector<char>& binary, unsigned int& format)
+	{
+		Record(CommandType::Other, 0, program);
+		return m_forward != nullptr ? m_forward->GetProgramBinary(program, binary, format) : false;
+	}
+
+	bool RecordingBackend::ProgramBinary(unsigned int program, unsigned int format, const void* binary, int size)
+	{
+		Record(CommandType::Other, format, program, 0, static_cast<unsigned int>(size));
+		return m_forward != nullptr ? m_forward->ProgramBinary(program, format, binary, size) : false;
+	}
+
+
+	unsigned int RecordingBackend::GenFramebuffer()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->GenFramebuffer() : NextName();
+	}
+
+	void RecordingBackend::DeleteFramebuffer(unsigned int framebuffer)
+	{
+		Record(CommandType::Other, 0, framebuffer);
+		if (m_forward != nullptr)
+			m_forward->DeleteFramebuffer(framebuffer);
+	}
+
+	void RecordingBackend::BindFramebuffer(unsigned int target, unsigned int framebuffer)
+	{
+		Record(CommandType::BindFramebuffer, target, framebuffer);
+		++m_stats.Binds;
+		if (m_forward != nullptr)
+			m_forward->BindFramebuffer(target, framebuffer);
+	}
+
+	unsigned int RecordingBackend::GenRenderbuffer()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->GenRenderbuffer() : NextName();
+	}
+
+	void RecordingBackend::DeleteRenderbuffer(unsigned int renderbuffer)
+	{
+		Record(CommandType::Other, 0, renderbuffer);
+		if (m_forward != nullptr)
+			m_forward->DeleteRenderbuffer(renderbuffer);
+	}
+
+	void RecordingBackend::RenderbufferStorage(unsigned int renderbuffer, unsigned int format, int width, int height)
+	{
+		Record(CommandType::Other, format, renderbuffer);
+		++m_stats.Allocations;
+		if (m_forward != nullptr)
+			m_forward->RenderbufferStorage(renderbuffer, format, width, height);
+	}
+
+	void RecordingBackend::FramebufferRenderbuffer(unsigned int target, unsigned int attachment, unsigned int renderbuffer)
+	{
+		Record(CommandType::Other, target, renderbuffer);
+		if (m_forward != nullptr)
+			m_forward->FramebufferRenderbuffer(target, attachment, renderbuffer);
+	}
+
+	void RecordingBackend::BlitFramebuffer(int x, int y, int width, int height, unsigned int mask)
+	{
+		Record(CommandType::BlitFramebuffer, mask, 0, 0, static_cast<unsigned int>(width * height));
+		m_stats.PixelsBlitted += static_cast<unsigned long long>(width) * height;
+		if (m_forward != nullptr)
+			m_forward->BlitFramebuffer(x, y, width, height, mask);
+	}
+
+
+	unsigned int RecordingBackend::GenTexture()
+	{
+		Record(CommandType::Other);
+		return m_forward != nullptr ? m_forward->GenTexture() : NextName();
+	}
+
+	void RecordingBackend::DeleteTexture(unsigned int texture)
+	{
+		Record(CommandType::Other, 0, texture);
+		if (m_forward != nullptr)
+			m_forward->DeleteTexture(texture);
+	}
+
+	void RecordingBackend::ActiveTexture(unsigned int unit)
+	{
+		Record(CommandType::Other, unit);
+		if (m_forward != nullptr)
+			m_forward->ActiveTexture(unit);
+	}
+
+	void RecordingBackend::BindTexture(unsigned int target, unsigned int texture)
+	{
+		Record(CommandType::BindTexture, target, texture);
+		++m_stats.Binds;
+		++m_stats.TextureBinds;
+		if (m_forward != nullptr)
+			m_forward->BindTexture(target, texture);
+	}
+
+	void RecordingBackend::TexImage2D(unsigned int target, unsigned int InternalFormat, int width, int height, unsigned int format, unsigned int type, const void* data)
+	{
+		unsigned int size = static_cast<unsigned int>(width * height) * PixelBytes(format);
+
+		Record(CommandType::TexImage, target, 0, 0, size);
+		++m_stats.Allocations;
+		if (data != nullptr)
+		{
+			++m_stats.Uploads;
+			m_stats.BytesUploaded += size;
+		}
+		if (m_forward != nullptr)
+			m_forward->TexImage2D(target, InternalFormat, width, height, format, type, data);
+	}
+
+	void RecordingBackend::TexSubImage2D(unsigned int target, int x, int y, int width, int height, unsigned int format, unsigned int type, const void* data)
+	{
+		unsigned int size = static_cast<unsigned int>(width * height) * PixelBytes(format);
+
+		Record(CommandType::TexImage, target, 0, 0, size);
+		++m_stats.Uploads;
+		m_stats.BytesUploaded += size;
+		if (m_forward != nullptr)
+			m_forward->TexSubImage2D(target, x, y, width, height, format, type, data);
+	}
+
+	void RecordingBackend::TexParameteri(unsigned int target, unsigned int name, int value)
+	{
+		Record(CommandType::Other, target);
+		if (m_forward != nullptr)
+			m_forward->TexParameteri(target, name, value);
+	}
+
+
+	int RecordingBackend::GetUniformLocation(unsigned int program, const char* name)
+	{
+		if (m_forward != nullptr)
+			return m_forward->GetUniformLocation(program, name);
+
+		//Every name gets its own location, shared by all the programs
+		auto it = m_locations.find(name);
+		if (it == m_locations.end())
+			it = m_locations.emplace(name, static_cast<int>(m_locations.size())).first;
+		return it->second;
+	}
+
+	void RecordingBackend::Uniform1i(int location, int v0)
+	{
+		Record(CommandType::Uniform, 0, static_cast<unsigned int>(location));
+		++m_stats.UniformUpdates;
+		if (m_forward != nullptr)
+			m_forward->Uniform1i(location, v0);
+	}
+
+	void RecordingBackend::Uniform1f(int location, float v0)
+	{
+		Record(CommandType::Uniform, 0, static_cast<unsigned int>(location));
+		++m_stats.UniformUpdates;
+		if (m_forward != nullptr)
+			m_forward->Uniform1f(location, v0);
+	}
+
+	void RecordingBackend::Uniform4f(int location, float v0, float v1, float v2, float v3)
+	{
+		Record(CommandType::Uniform, 0, static_cast<unsigned int>(location));
+		++m_stats.UniformUpdates;
+		if (m_forward != nullptr)
+			m_forward->Uniform4f(location, v0, v1, v2, v3);
+	}
+
+	void RecordingBackend::UniformMatrix4fv(int location, const float* value)
+	{
+		Record(CommandType::Uniform, 0, static_cast<unsigned int>(location));
+		++m_stats.UniformUpdates;
+		if (m_forward != nullptr)
+			m_forward->UniformMatrix4fv(location, value);
+	}
+
+	unsigned int RecordingBackend::GetUniformBlockIndex(unsigned int program, const char* name)
+	{
+		if (m_forward != nullptr)
+			return m_forward->GetUniformBlockIndex(program, name);
+		return 0;
+	}
+
+	void RecordingBackend::UniformBlockBinding(unsigned int program, unsigned int block, unsigned int binding)
+	{
+		Record(CommandType::Other, 0, program, block, binding);
+		if (m_forward != nullptr)
+			m_forward->UniformBlockBinding(program, block, binding);
+	}
+
+	int RecordingBackend::UniformBufferOffsetAlignment()
+	{
+		//The largest alignment drivers report, so null runs upload what a GPU run would
+		return m_forward != nullptr ? m_forward->UniformBufferOffsetAlignment() : 256;
+	}
+
+
+	void RecordingBackend::DrawElements(unsigned int mode, int count, unsigned int type, unsigned int offset)
+	{
+		Record(CommandType::DrawElements, mode, 0, offset, static_cast<unsigned int>(count), 1);
+		++m_stats.DrawCalls;
+		m_stats.IndicesDrawn += static_cast<unsigned int>(count);
+		++m_stats.Instances;
+		if (m_forward != nullptr)
+			m_forward->DrawElements(mode, count, type, offset);
+	}
+
+	void RecordingBackend::DrawElementsInstanced(unsigned int mode, int count, unsigned int type, unsigned int offset, int instances)
+	{
+		Record(CommandType::DrawElementsInstanced, mode, 0, offset, static_cast<unsigned int>(count), static_cast<unsigned int>(instances));
+		++m_stats.DrawCalls;
+		m_stats.IndicesDrawn += static_cast<unsigned long long>(count) * static_cast<unsigned long long>(instances);
+		m_stats.Instances += static_cast<unsigned int>(instances);
+		if (m_forward != nullptr)
+			m_forward->DrawElementsInstanced(mode, count, type, offset, instances);
+	}
+
+	void RecordingBackend::Clear(unsigned int mask)
+	{
+		Record(CommandType::Clear, mask);
+		if (m_forward != nullptr)
+			m_forward->Clear(mask);
+	}
+
+	void RecordingBackend::Viewport(int x, int y, int width, int height)
+	{
+		Record(CommandType::Other);
+		if (m_forward != nullptr)
+			m_forward->Viewport(x, y, width, height);
+	}
+
+	void RecordingBackend::Enable(unsigned int capability)
+	{
+		Record(CommandType::Other, capability);
+		if (m_forward != nullptr)
+			m_forward->Enable(capability);
+	}
+
+	void RecordingBackend::Disable(unsigned int capability)
+	{
+		Record(CommandType::Other, capability);
+		if (m_forward != nullptr)
+			m_forward->Disable(capability);
+	}
+
+	void RecordingBackend::Scissor(int x, int y, int width, int height)
+	{
+		Record(CommandType::Scissor, 0, 0, 0, static_cast<unsigned int>(width * height));
+		if (m_forward != nullptr)
+			m_forward->Scissor(x, y, width, height);
+	}
+
+	void RecordingBackend::BlendFunc(unsigned int source, unsigned int destination)
+	{
+		Record(CommandType::Other);
+		if (m_forward != nullptr)
+			m_forward->BlendFunc(source, destination);
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Backend.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Kind of a recorded command, calls that only build objects are recorded as Other.
+	 */
+	enum class CommandType
+	{
+		BindBuffer,
+		BufferData,
+		BufferSubData,
+		FlushMappedBufferRange,
+		BindVertexArray,
+		VertexAttribPointer,
+		UseProgram,
+		Uniform,
+		DrawElements,
+		DrawElementsInstanced,
+		Clear,
+		Scissor,
+		BindFramebuffer,
+		BlitFramebuffer,
+		BindTexture,
+		TexImage,
+		Other
+	};
+
+	/**
+	 * @brief One recorded command, the meaning of the fields depends on the type.
+	 */
+	struct Command
+	{
+		CommandType type;
+		unsigned int target;    /// Buffer, framebuffer or texture target, draw mode, clear or blit mask
+		unsigned int object;    /// Buffer, vertex array, program, framebuffer, texture or uniform location
+		unsigned int offset;    /// Byte offset into the buffer
+		unsigned int size;      /// Bytes uploaded, indices drawn, pixels scissored or blitted
+		unsigned int instances; /// Instances drawn
+	};
+
+	/**
+	 * @brief Totals of the recorded commands.
+	 */
+	struct BackendStats
+	{
+		unsigned long long Commands = 0;
+		unsigned long long Binds = 0;          /// Buffer, vertex array, program, framebuffer and texture binds
+		unsigned long long TextureBinds = 0;
+		unsigned long long Uploads = 0;        /// Buffer and texture uploads with data, mapped ranges flushed
+		unsigned long long BytesUploaded = 0;
+		unsigned long long Allocations = 0;    /// BufferData, RenderbufferStorage and TexImage2D calls, they (re)allocate the storage
+		unsigned long long UniformUpdates = 0;
+		unsigned long long DrawCalls = 0;
+		unsigned long long IndicesDrawn = 0;   /// Indices submitted, multiplied by the instances
+		unsigned long long Instances = 0;
+		unsigned long long PixelsBlitted = 0;
+	};
+
+	/**
+	 * @brief Backend that captures the command stream in memory.
+	 *
+	 * On its own it is a null backend: names are handed out from counters, shaders always compile
+	 * and link, nothing is drawn and buffers cannot be mapped. Given another backend it records and forwards every call to it,
+	 * which gives exact upload and draw statistics of a real run.
+	 */
+	class RecordingBackend : public Backend
+	{
+	public:
+
+		/**
+		 * @param forward Backend the calls are forwarded to, nullptr for none.
+		 * @param KeepCommands False to only accumulate the stats, long runs then use no memory.
+		 */
+		explicit RecordingBackend(Backend* forward = nullptr, bool KeepCommands = true);
+
+		inline const std::vector<Command>& Commands() const { return m_commands; }
+		inline const BackendStats& Stats() const { return m_stats; }
+
+		/**
+		 * @brief Clears the recorded commands and the stats, objects created so far stay valid.
+		 */
+		void Reset();
+
+		unsigned int GenBuffer() override;
+		void DeleteBuffer(unsigned int buffer) override;
+		void BindBuffer(unsigned int target, unsigned int buffer) override;
+		void BufferData(unsigned int target, unsigned int size, const void* data, unsigned int usage) override;
+		void BufferSubData(unsigned int target, unsigned int offset, unsigned int size, const void* data) override;
+		void BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size) override;
+
+		bool BufferStorage(unsigned int target, unsigned int size, unsigned int flags) override;
+		void* MapBufferRange(unsigned int target, unsigned int offset, unsigned int size, unsigned int access) override;
+		void FlushMappedBufferRange(unsigned int target, unsigned int offset, unsigned int size) override;
+		void UnmapBuffer(unsigned int target) override;
+		void* FenceSync() override;
+		void ClientWaitSync(void* fence) override;
+		void DeleteSync(void* fence) override;
+
+		unsigned int GenVertexArray() override;
+		void DeleteVertexArray(unsigned int array) override;
+		void BindVertexArray(unsigned int array) override;
+		void EnableVertexAttribArray(unsigned int index) override;
+		void VertexAttribPointer(unsigned int index, int count, unsigned int type, bool normalized, int stride, unsigned int offset) override;
+		void VertexAttribIPointer(unsigned int index, int count, unsigned int type, int stride, unsigned int offset) override;
+		void VertexAttribDivisor(unsigned int index, unsigned int divisor) override;
+
+		unsigned int CreateShader(unsigned int type) override;
+		void ShaderSource(unsigned int shader, const char* source) override;
+		void CompileShader(unsigned int shader) override;
+		int GetShaderiv(unsigned int shader, unsigned int pname) override;
+		void GetShaderInfoLog(unsigned int shader, int size, char* log) override;
+		void DeleteShader(unsigned int shader) override;
+		unsigned int CreateProgram() override;
+		void AttachShader(unsigned int program, unsigned int shader) override;
+		void LinkProgram(unsigned int program) override;
+		void ValidateProgram(unsigned int program) override;
+		int GetProgramiv(unsigned int program, unsigned int pname) override;
+		void GetProgramInfoLog(unsigned int program, int size, char* log) override;
+		void DeleteProgram(unsigned int program) override;
+		void UseProgram(unsigned int program) override;
+
+		void ProgramBinaryRetrievable(unsigned int program) override;
+		bool GetProgramBinary(unsigned int program, std::vector<char>& binary, unsigned int& format) override;
+		bool ProgramBinary(unsigned int program, unsigned int format, const void* binary, int size) override;
+
+		unsigned int GenFramebuffer() override;
+		void DeleteFramebuffer(unsigned int framebuffer) override;
+		void BindFramebuffer(unsigned int target, unsigned int framebuffer) override;
+		unsigned int GenRenderbuffer() override;
+		void DeleteRenderbuffer(unsigned int renderbuffer) override;
+		void RenderbufferStorage(unsigned int renderbuffer, unsigned int format, int width, int height) override;
+		void FramebufferRenderbuffer(unsigned int target, unsigned int attachment, unsigned int renderbuffer) override;
+		void BlitFramebuffer(int x, int y, int width, int height, unsigned int mask) override;
+
+		unsigned int GenTexture() override;
+		void DeleteTexture(unsigned int texture) override;
+		void ActiveTexture(unsigned int unit) override;
+		void BindTexture(unsigned int target, unsigned int texture) override;
+		void TexImage2D(unsigned int target, unsigned int InternalFormat, int width, int height, unsigned int format, unsigned int type, const void* data) override;
+		void TexSubImage2D(unsigned int target, int x, int y, int width, int height, unsigned int format, unsigned int type, const void* data) override;
+		void TexParameteri(unsigned int target, unsigned int name, int value) override;
+
+		int GetUniformLocation(unsigned int program, const char* name) override;
+		void Uniform1i(int location, int v0) override;
+		void Uniform1f(int location, float v0) override;
+		void Uniform4f(int location, float v0, float v1, float v2, float v3) override;
+		void UniformMatrix4fv(int location, const float* value) override;
+		unsigned int GetUniformBlockIndex(unsigned int program, const char* name) override;
+		void UniformBlockBinding(unsigned int program, unsigned int block, unsigned int binding) override;
+		int UniformBufferOffsetAlignment() override;
+
+		void DrawElements(unsigned int mode, int count, unsigned int type, unsigned int offset) override;
+		void DrawElementsInstanced(unsigned int mode, int count, unsigned int type, unsigned int offset, int instances) override;
+		void Clear(unsigned int mask) override;
+		void Viewport(int x, int y, int width, int height) override;
+		void Enable(unsigned int capability) override;
+		void Disable(unsigned int capability) override;
+		void Scissor(int x, int y, int width, int height) override;
+		void BlendFunc(unsigned int source, unsigned int destination) override;
+
+	private:
+		Backend* m_forward;
+		bool m_KeepCommands;
+		std::vector<Command> m_commands;
+		BackendStats m_stats;
+
+		unsigned int m_NextName;
+		std::unordered_map<std::string, int> m_locations;
+
+		void Record(CommandType type, unsigned int target = 0, unsigned int object = 0, unsigned int offset = 0, unsigned int size = 0, unsigned int instances = 0);
+
+		unsigned int NextName();
+
+	}; // class RecordingBackend
+
+} // namespace Vicetrice
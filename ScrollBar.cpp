@@ -0,0 +1,121 @@
+#include "ScrollBar.hpp"
+#include <algorithm>
+
+namespace Vicetrice
+{
+	ScrollBar::ScrollBar(WidgetTree& tree, Widget* parent, const LayoutStyle& style, float width, float MinThumbHeight)
+		: Widget{ tree, parent, style },
+		m_width{ width },
+		m_MinThumbHeight{ MinThumbHeight },
+		m_count{ 0 },
+		m_page{ 0 },
+		m_position{ 0 },
+		m_offset{ 0.0f },
+		m_dragging{ false }
+	{
+		SetSize(LayoutSize::Pixels(0.0f));
+	}
+
+	void ScrollBar::SetRange(unsigned int count, unsigned int page)
+	{
+		if (count == m_count && page == m_page)
+			return;
+
+		m_count = count;
+		m_page = page;
+		m_position = std::min(m_position, Steps());
+		if (!Visible())
+			m_dragging = false;
+
+		SetSize(LayoutSize::Pixels(Visible() ? m_width : 0.0f));
+		Invalidate();
+	}
+
+	void ScrollBar::SetPosition(unsigned int position)
+	{
+		position = std::min(position, Steps());
+		if (position == m_position)
+			return;
+
+		m_position = position;
+		if (!m_dragging)
+			Invalidate();
+	}
+
+	bool ScrollBar::Press(float x, float y)
+	{
+		if (!Visible() || !ThumbRect().Contains(x, y))
+			return false;
+
+		m_offset = Offset();
+		m_dragging = true;
+		return true;
+	}
+
+	bool ScrollBar::Drag(float dy)
+	{
+		if (!m_dragging)
+			return false;
+
+		float travel = std::max(0.0f, Content().Height() - ThumbSize());
+		m_offset = std::min(std::max(m_offset + dy, 0.0f), travel);
+		Invalidate();
+
+		float step = StepSize();
+		unsigned int position = step > 0.0f ? std::min(static_cast<unsigned int>(m_offset / step), Steps()) : 0;
+		if (position == m_position)
+			return false;
+
+		m_position = position;
+		return true;
+	}
+
+	void ScrollBar::Release()
+	{
+		if (!m_dragging)
+			return;
+
+		m_dragging = false;
+		Invalidate();
+	}
+
+	float ScrollBar::ThumbSize() const
+	{
+		float track = Content().Height();
+		if (m_count == 0)
+			return track;
+
+		float size = std::max(m_MinThumbHeight, track * static_cast<float>(m_page) / static_cast<float>(m_count));
+		return std::min(size, track);
+	}
+
+	float ScrollBar::StepSize() const
+	{
+		unsigned int steps = Steps();
+		float range = Content().Height() - ThumbSize();
+
+		return steps != 0 ? range / steps : range;
+	}
+
+	LayoutRect ScrollBar::ThumbRect() const
+	{
+		const LayoutRect& track = Content();
+
+		LayoutRect thumb = track;
+		thumb.top = track.top + Offset();
+		thumb.bottom = std::min(thumb.top + ThumbSize(), track.bottom);
+		return thumb;
+	}
+
+	void ScrollBar::Tessellate(std::vector<float>& batch) const
+	{
+		if (Visible())
+			m_tree.AddRect(batch, ThumbRect(), glm::vec4(1.0f), Rect());
+	}
+
+	float ScrollBar::Offset() const
+	{
+		return m_dragging ? m_offset : StepSize() * static_cast<float>(m_position);
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Widget.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Vertical scrollbar: a thumb dragged along the content box of the widget, the track.
+	 *
+	 * The range is counted in steps, one per item that does not fit in the page. The thumb is to the
+	 * track what the page is to all the items, never shorter than a minimum. While it is dragged the
+	 * thumb follows the pointer and Position() is the step under it, after the release it snaps to
+	 * that step. The bar takes no room while everything fits.
+	 */
+	class ScrollBar : public Widget
+	{
+	public:
+
+		/**
+		 * @param width Size of the widget in pixels along the direction of its parent while it is shown.
+		 * @param MinThumbHeight Shortest thumb, in pixels.
+		 */
+		ScrollBar(WidgetTree& tree, Widget* parent, const LayoutStyle& style, float width, float MinThumbHeight);
+
+		/**
+		 * @brief Sets how many items there are and how many fit in a page, the position is clamped to the new range.
+		 */
+		void SetRange(unsigned int count, unsigned int page);
+
+		/**
+		 * @brief Checks if some items do not fit in a page, the bar is hidden otherwise.
+		 */
+		inline bool Visible() const { return m_count > m_page; }
+
+		/**
+		 * @brief Last position, the items that do not fit in a page.
+		 */
+		inline unsigned int Steps() const { return m_count > m_page ? m_count - m_page : 0; }
+
+		/**
+		 * @brief First item shown.
+		 */
+		inline unsigned int Position() const { return m_position; }
+
+		/**
+		 * @brief Scrolls to a position, clamped to Steps(). A thumb being dragged stays under the pointer.
+		 */
+		void SetPosition(unsigned int position);
+
+		/**
+		 * @brief Starts dragging the thumb if a mouse position falls on it.
+		 *
+		 * @return True if the thumb was grabbed.
+		 */
+		bool Press(float x, float y);
+
+		/**
+		 * @brief Moves the thumb being dragged.
+		 *
+		 * @param dy Pixels the pointer moved downwards.
+		 * @return True if Position() changed.
+		 */
+		bool Drag(float dy);
+
+		/**
+		 * @brief Ends the drag, the thumb snaps to Position().
+		 */
+		void Release();
+
+		inline bool Dragging() const { return m_dragging; }
+
+		/**
+		 * @brief Height of the thumb in pixels.
+		 */
+		float ThumbSize() const;
+
+		/**
+		 * @brief Thumb displacement in pixels that scrolls by one step.
+		 */
+		float StepSize() const;
+
+		/**
+		 * @brief Rectangle of the thumb in pixels.
+		 */
+		LayoutRect ThumbRect() const;
+
+	protected:
+		void Tessellate(std::vector<float>& batch) const override;
+
+	private:
+		float m_width;
+		float m_MinThumbHeight;
+		unsigned int m_count;
+		unsigned int m_page;
+		unsigned int m_position;
+		float m_offset;                /// Distance from the top of the track to the thumb while it is dragged.
+		bool m_dragging;
+
+		/**
+		 * @brief Distance from the top of the track to the thumb.
+		 */
+		float Offset() const;
+
+	}; // class ScrollBar
+
+} // namespace Vicetrice
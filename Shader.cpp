@@ -1,73 +1,135 @@
 #include "Shader.hpp"
 #include <GL/glew.h>
 #include <sstream>
+#include <vector>
 #include <fstream>
-#include "Error.hpp"
+#include <filesystem>
+#include <functional>
+#include <cstdint>
+#include "Backend.hpp"
+#include <cassert>
 #include <iostream>
 #include "vendor/glm/glm.hpp"
 #include "vendor/glm/gtc/matrix_transform.hpp"
 
 namespace Vicetrice
 {
-	Shader::Shader(const std::string& filepath) : m_RendererID{ 0 }
+	static const uint32_t BinaryMagic = 0x31425356; // "VSB1"
+
+	Shader::Shader(const std::string& filepath, const std::string& defines, const std::string& BinaryDirectory) : m_RendererID{ 0 }
 	{
 		ShaderProgramSource source = ParseShader(filepath);
+		source.VertexSource = InsertDefines(source.VertexSource, defines);
+		source.FragmentSource = InsertDefines(source.FragmentSource, defines);
+
+		if (BinaryDirectory.empty())
+		{
+			m_RendererID = CreateShader(source.VertexSource, source.FragmentSource, false);
+			return;
+		}
+
+		// Named after the final sources, an edited shader never picks up a stale binary
+		size_t hash = std::hash<std::string>{}(source.VertexSource + '\0' + source.FragmentSource);
+		std::stringstream name;
+		name << std::hex << hash << ".bin";
+		std::string path = (std::filesystem::path(BinaryDirectory) / name.str()).string();
+
+		if (LoadBinary(path))
+			return;
 
-		m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+		m_RendererID = CreateShader(source.VertexSource, source.FragmentSource, true);
+		SaveBinary(path);
 	}
 
 	Shader::~Shader()
 	{
-		GLCall(glDeleteProgram(m_RendererID));
+		Backend::Get().DeleteProgram(m_RendererID);
 
 	}
 
 	void Shader::Bind() const
 	{
 
-		GLCall(glUseProgram(m_RendererID));
+		Backend::Get().UseProgram(m_RendererID);
 
 	}
 
 	void Shader::Unbind() const
 	{
-		GLCall(glUseProgram(0));
+		Backend::Get().UseProgram(0);
 	}
 
 	void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 	{
-		GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
+		Backend::Get().Uniform4f(GetUniformLocation(name), v0, v1, v2, v3);
 
 	}
 
 	void Shader::SetUniform4f(const std::string& name, const float(&v)[4])
 	{
-		GLCall(glUniform4f(GetUniformLocation(name), v[0], v[1], v[2], v[3]));
+		Backend::Get().Uniform4f(GetUniformLocation(name), v[0], v[1], v[2], v[3]);
 	}
 
 	void Shader::SetUniform1f(const std::string& name, float v0)
 	{
-		GLCall(glUniform1f(GetUniformLocation(name), v0));
+		Backend::Get().Uniform1f(GetUniformLocation(name), v0);
 	}
 
 	void Shader::SetUniform1i(const std::string& name, int v0)
 	{
-		GLCall(glUniform1i(GetUniformLocation(name), v0));
+		Backend::Get().Uniform1i(GetUniformLocation(name), v0);
 	}
 
 	void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 	{
-		GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+		Backend::Get().UniformMatrix4fv(GetUniformLocation(name), &matrix[0][0]);
+	}
+
+
+	UniformHandle Shader::Uniform(const std::string& name)
+	{
+		return UniformHandle{ GetUniformLocation(name) };
+	}
+
+	void Shader::SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3) const
+	{
+		Backend::Get().Uniform4f(uniform.location, v0, v1, v2, v3);
+	}
+
+	void Shader::SetUniform1f(UniformHandle uniform, float v0) const
+	{
+		Backend::Get().Uniform1f(uniform.location, v0);
+	}
+
+	void Shader::SetUniform1i(UniformHandle uniform, int v0) const
+	{
+		Backend::Get().Uniform1i(uniform.location, v0);
+	}
+
+	void Shader::SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix) const
+	{
+		Backend::Get().UniformMatrix4fv(uniform.location, &matrix[0][0]);
+	}
+
+	void Shader::BindUniformBlock(const char* name, unsigned int binding) const
+	{
+		Backend& backend = Backend::Get();
+
+		unsigned int block = backend.GetUniformBlockIndex(m_RendererID, name);
+		assert(block != GL_INVALID_INDEX);
+
+		backend.UniformBlockBinding(m_RendererID, block, binding);
 	}
 
 
 	int Shader::GetUniformLocation(const std::string& name)
 	{
-		if (m_UlocationCache.find(name) != m_UlocationCache.end())
+		auto it = m_UlocationCache.find(name);
+		if (it != m_UlocationCache.end())
 		{
-			return m_UlocationCache.at(name);
+			return it->second;
 		}
-		int location = glGetUniformLocation(m_RendererID, name.c_str());
+		int location = Backend::Get().GetUniformLocation(m_RendererID, name.c_str());
 		assert(location != -1);
 
 		m_UlocationCache[name] = location;
@@ -107,62 +169,125 @@ namespace Vicetrice
 
 	unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 	{
-		GLCall(unsigned int id = glCreateShader(type));
-		const char* src = source.c_str();
-		GLCall(glShaderSource(id, 1, &src, nullptr));
-		GLCall(glCompileShader(id));
+		Backend& backend = Backend::Get();
+		unsigned int id = backend.CreateShader(type);
+		backend.ShaderSource(id, source.c_str());
+		backend.CompileShader(id);
 
 		// Error handling
-		int result;
-		GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
+		int result = backend.GetShaderiv(id, GL_COMPILE_STATUS);
 		if (result == GL_FALSE)
 		{
-			int length;
-			GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
-			char* message = (char*)_malloca(length * sizeof(char));
-			GLCall(glGetShaderInfoLog(id, length, &length, message));
+			int length = backend.GetShaderiv(id, GL_INFO_LOG_LENGTH);
+			std::vector<char> buffer(length > 0 ? length : 1, '\0');
+			char* message = buffer.data();
+			backend.GetShaderInfoLog(id, static_cast<int>(buffer.size()), message);
 			std::cout
 				<< "Failed to compile "
 				<< (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
 				<< "shader"
 				<< std::endl;
 			std::cout << message << std::endl;
-			GLCall(glDeleteShader(id));
+			backend.DeleteShader(id);
 			return 0;
 		}
 
 		return id;
 	}
 
-	unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+	unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader, bool retrievable)
 	{
 		// create a shader program
-		unsigned int program = glCreateProgram();
+		Backend& backend = Backend::Get();
+		unsigned int program = backend.CreateProgram();
 		unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
 		unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
-		GLCall(glAttachShader(program, vs));
-		GLCall(glAttachShader(program, fs));
+		backend.AttachShader(program, vs);
+		backend.AttachShader(program, fs);
 
-		GLCall(glLinkProgram(program));
+		if (retrievable)
+			backend.ProgramBinaryRetrievable(program);
 
-		GLint program_linked;
+		backend.LinkProgram(program);
 
-		GLCall(glGetProgramiv(program, GL_LINK_STATUS, &program_linked));
+		int program_linked = backend.GetProgramiv(program, GL_LINK_STATUS);
 		if (program_linked != GL_TRUE)
 		{
-			GLsizei log_length = 0;
-			GLchar message[1024];
-			GLCall(glGetProgramInfoLog(program, 1024, &log_length, message));
+			char message[1024];
+			backend.GetProgramInfoLog(program, 1024, message);
 			std::cout << "Failed to link program" << std::endl;
 			std::cout << message << std::endl;
 		}
 
-		GLCall(glValidateProgram(program));
+		backend.ValidateProgram(program);
 
-		GLCall(glDeleteShader(vs));
-		GLCall(glDeleteShader(fs));
+		backend.DeleteShader(vs);
+		backend.DeleteShader(fs);
 
 		return program;
 	}
+
+	std::string Shader::InsertDefines(const std::string& source, const std::string& defines)
+	{
+		if (defines.empty())
+			return source;
+
+		// #version has to stay the first statement
+		size_t version = source.find("#version");
+		size_t line = version != std::string::npos ? source.find('\n', version) : std::string::npos;
+		if (line == std::string::npos)
+			return defines + '\n' + source;
+
+		std::string result = source;
+		result.insert(line + 1, defines.back() == '\n' ? defines : defines + '\n');
+		return result;
+	}
+
+	bool Shader::LoadBinary(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+
+		uint32_t header[2] = { 0, 0 };
+		file.read(reinterpret_cast<char*>(header), sizeof(header));
+		if (!file || header[0] != BinaryMagic)
+			return false;
+
+		std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (binary.empty())
+			return false;
+
+		// Rejected after a driver update or on another GPU, the caller compiles and overwrites it
+		Backend& backend = Backend::Get();
+		unsigned int program = backend.CreateProgram();
+		if (!backend.ProgramBinary(program, header[1], binary.data(), static_cast<int>(binary.size())))
+		{
+			backend.DeleteProgram(program);
+			return false;
+		}
+
+		m_RendererID = program;
+		return true;
+	}
+
+	void Shader::SaveBinary(const std::string& path) const
+	{
+		std::vector<char> binary;
+		unsigned int format = 0;
+		if (!Backend::Get().GetProgramBinary(m_RendererID, binary, format))
+			return;
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return;
+
+		const uint32_t header[2] = { BinaryMagic, format };
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+	}
 } //namespace Vicetrice
\ No newline at end of file
@@ -16,11 +16,24 @@ namespace Vicetrice
 		std::string FragmentSource;
 	};
 
+	/**
+	 * @brief Uniform location resolved once with Shader::Uniform, the setters taking it skip the name lookup.
+	 */
+	struct UniformHandle
+	{
+		int location = -1;
+	};
+
 	class Shader
 	{
 	public:
 
-		Shader(const std::string& filepath);
+		/**
+		 * @param filepath File with the #shader vertex and #shader fragment sections.
+		 * @param defines Lines inserted after the #version line of both stages, e.g. "#define ROUNDED 1\n".
+		 * @param BinaryDirectory Directory where the linked program is stored and loaded from, empty to always compile.
+		 */
+		Shader(const std::string& filepath, const std::string& defines = "", const std::string& BinaryDirectory = "");
 		~Shader();
 
 		void Bind() const;
@@ -31,6 +44,21 @@ namespace Vicetrice
 		void SetUniform1i(const std::string& name, int v0);
 		void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
 
+		/**
+		 * @brief Resolves a uniform once, keep the handle instead of passing the name every draw.
+		 */
+		UniformHandle Uniform(const std::string& name);
+
+		void SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3) const;
+		void SetUniform1f(UniformHandle uniform, float v0) const;
+		void SetUniform1i(UniformHandle uniform, int v0) const;
+		void SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix) const;
+
+		/**
+		 * @brief Makes the uniform block name read the buffer range bound to binding, see UniformBuffer::BindRange.
+		 */
+		void BindUniformBlock(const char* name, unsigned int binding) const;
+
 	private:
 		unsigned int m_RendererID;
 		std::unordered_map<std::string, int> m_UlocationCache;
@@ -43,6 +71,12 @@ namespace Vicetrice
 
 		unsigned int CompileShader(unsigned int type, const std::string& source);
 
-		unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+		unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader, bool retrievable);
+
+		static std::string InsertDefines(const std::string& source, const std::string& defines);
+
+		bool LoadBinary(const std::string& path);
+
+		void SaveBinary(const std::string& path) const;
 	}; //class Shader
 } //namespace Vicetrice
@@ -0,0 +1,26 @@
+#include "ShaderCache.hpp"
+
+namespace Vicetrice
+{
+	std::unordered_map<std::string, std::weak_ptr<Shader>> ShaderCache::s_programs;
+	std::string ShaderCache::s_BinaryDirectory;
+
+	std::shared_ptr<Shader> ShaderCache::Get(const std::string& path, const std::string& defines)
+	{
+		const std::string key = path + '\n' + defines;
+
+		std::weak_ptr<Shader>& entry = s_programs[key];
+		if (std::shared_ptr<Shader> shader = entry.lock())
+			return shader;
+
+		std::shared_ptr<Shader> shader = std::make_shared<Shader>(path, defines, s_BinaryDirectory);
+		entry = shader;
+		return shader;
+	}
+
+	void ShaderCache::SetBinaryDirectory(const std::string& directory)
+	{
+		s_BinaryDirectory = directory;
+	}
+
+} // namespace Vicetrice
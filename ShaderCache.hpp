@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Shader.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Programs shared by every user of the same shader file and defines.
+	 *
+	 * Each Window used to compile and link Window.shader and Icon.shader on its own. The cache hands
+	 * out the same program instead, and frees it with its last user, so nothing outlives the context.
+	 * With a binary directory set, linked programs are also written to disk and loaded from there on
+	 * the next run, when the driver supports program binaries.
+	 */
+	class ShaderCache
+	{
+	public:
+
+		/**
+		 * @brief Program for a shader file, compiled on the first request.
+		 *
+		 * @param path Shader file.
+		 * @param defines Lines inserted after the #version line, part of the key.
+		 */
+		static std::shared_ptr<Shader> Get(const std::string& path, const std::string& defines = "");
+
+		/**
+		 * @brief Directory for the linked programs, empty (the default) compiles them from source every run.
+		 */
+		static void SetBinaryDirectory(const std::string& directory);
+
+		inline static const std::string& BinaryDirectory() { return s_BinaryDirectory; }
+
+	private:
+		static std::unordered_map<std::string, std::weak_ptr<Shader>> s_programs; /// By path and defines.
+		static std::string s_BinaryDirectory;
+
+	}; // class ShaderCache
+
+} // namespace Vicetrice
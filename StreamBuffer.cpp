@@ -0,0 +1,192 @@
+#include "StreamBuffer.hpp"
+#include "Backend.hpp"
+#include "Profiler.hpp"
+#include <GL/glew.h>
+
+namespace Vicetrice
+{
+	StreamBuffer::StreamBuffer(unsigned int SegmentSize)
+		: m_vb{},
+		m_mode{ Mode::Persistent },
+		m_SegmentSize{ 0 },
+		m_head{ 0 },
+		m_segment{ 0 },
+		m_MapOffset{ 0 },
+		m_MapSize{ 0 },
+		m_persistent{ nullptr },
+		m_fences{},
+		m_staging{}
+	{
+		Create(SegmentSize > 0 ? SegmentSize : 1);
+	}
+
+	StreamBuffer::~StreamBuffer()
+	{
+		Release();
+	}
+
+	void StreamBuffer::Create(unsigned int SegmentSize)
+	{
+		Backend& backend = Backend::Get();
+		unsigned int total = SegmentSize * Segments;
+
+		m_SegmentSize = SegmentSize;
+		m_head = 0;
+		m_segment = 0;
+		m_vb = std::make_unique<VertexBuffer>(nullptr, 0);
+
+		if (m_mode == Mode::Persistent)
+		{
+			m_vb->Bind();
+			if (backend.BufferStorage(GL_ARRAY_BUFFER, total, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT))
+			{
+				m_persistent = static_cast<char*>(backend.MapBufferRange(GL_ARRAY_BUFFER, 0, total, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+				if (m_persistent != nullptr)
+					return;
+
+				// Immutable storage that cannot be mapped, start over with a mutable one
+				m_vb = std::make_unique<VertexBuffer>(nullptr, 0);
+			}
+			m_mode = Mode::Unsynchronized;
+		}
+
+		m_vb->Allocate(nullptr, total);
+	}
+
+	void StreamBuffer::Release()
+	{
+		Backend& backend = Backend::Get();
+
+		for (void*& fence : m_fences)
+		{
+			if (fence != nullptr)
+				backend.DeleteSync(fence);
+			fence = nullptr;
+		}
+
+		if (m_persistent != nullptr)
+		{
+			m_vb->Bind();
+			backend.UnmapBuffer(GL_ARRAY_BUFFER);
+			m_persistent = nullptr;
+		}
+
+		m_vb.reset();
+	}
+
+	void* StreamBuffer::Map(unsigned int size, unsigned int alignment)
+	{
+		Backend& backend = Backend::Get();
+
+		// Room to align the start of a segment and still fit the write in it
+		unsigned int needed = size + (alignment > 1 ? alignment - 1 : 0);
+		if (needed > m_SegmentSize)
+		{
+			unsigned int SegmentSize = m_SegmentSize * 2;
+			while (SegmentSize < needed)
+				SegmentSize *= 2;
+
+			// The GPU may still read the old buffer, deleting it in GL waits for that
+			Release();
+			Create(SegmentSize);
+		}
+
+		unsigned int total = m_SegmentSize * Segments;
+		unsigned int offset = alignment > 1 ? (m_head + alignment - 1) / alignment * alignment : m_head;
+
+		// A write never straddles two segments, so the fence placed when the writes leave a segment
+		// comes after the draws of everything written to it
+		unsigned int segment = offset / m_SegmentSize;
+		if (segment < Segments && offset + size > (segment + 1) * m_SegmentSize)
+		{
+			++segment;
+			offset = alignment > 1 ? (segment * m_SegmentSize + alignment - 1) / alignment * alignment : segment * m_SegmentSize;
+		}
+
+		bool wrapped = segment >= Segments;
+		if (wrapped)
+		{
+			offset = 0;
+			segment = 0;
+		}
+
+		// Fence the segments left behind, wait for the ones entered
+		while (m_segment != segment)
+		{
+			if (m_mode != Mode::Orphan)
+			{
+				if (m_fences[m_segment] != nullptr)
+					backend.DeleteSync(m_fences[m_segment]);
+				m_fences[m_segment] = backend.FenceSync();
+			}
+
+			m_segment = (m_segment + 1) % Segments;
+
+			if (m_fences[m_segment] != nullptr)
+			{
+				backend.ClientWaitSync(m_fences[m_segment]);
+				backend.DeleteSync(m_fences[m_segment]);
+				m_fences[m_segment] = nullptr;
+			}
+		}
+
+		m_MapOffset = offset;
+		m_MapSize = size;
+
+		switch (m_mode)
+		{
+		case Mode::Persistent:
+			return m_persistent + offset;
+
+		case Mode::Unsynchronized:
+		{
+			m_vb->Bind();
+			void* data = backend.MapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+			if (data != nullptr)
+				return data;
+
+			// No mapping in this backend, BufferSubData from now on
+			m_mode = Mode::Orphan;
+			break;
+		}
+
+		default:
+			if (wrapped)
+				m_vb->Allocate(nullptr, total);
+			break;
+		}
+
+		if (m_staging.size() < size)
+			m_staging.resize(size);
+		return m_staging.data();
+	}
+
+	unsigned int StreamBuffer::Commit()
+	{
+		Backend& backend = Backend::Get();
+
+		m_vb->Bind();
+
+		switch (m_mode)
+		{
+		case Mode::Persistent:
+			backend.FlushMappedBufferRange(GL_ARRAY_BUFFER, m_MapOffset, m_MapSize);
+			VICE_PROFILE_COUNT(BufferBytes, m_MapSize);
+			break;
+
+		case Mode::Unsynchronized:
+			backend.FlushMappedBufferRange(GL_ARRAY_BUFFER, 0, m_MapSize);
+			backend.UnmapBuffer(GL_ARRAY_BUFFER);
+			VICE_PROFILE_COUNT(BufferBytes, m_MapSize);
+			break;
+
+		default:
+			m_vb->Update(m_staging.data(), m_MapSize, m_MapOffset);
+			break;
+		}
+
+		m_head = m_MapOffset + m_MapSize;
+		return m_MapOffset;
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "VertexBuffer.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Vertex buffer for data rewritten every frame, written straight into mapped memory.
+	 *
+	 * The storage is a ring split in three segments, a fence is placed when the writes leave a
+	 * segment and waited on before they come back to it, so the GPU can still be reading the last
+	 * two frames while the next one is written. Depending on the context the ring is
+	 *	Persistent      mapped once (GL 4.4 / ARB_buffer_storage)
+	 *	Unsynchronized  mapped for every write with GL_MAP_UNSYNCHRONIZED_BIT
+	 *	Orphan          not mapped, written with BufferSubData and orphaned when it wraps
+	 */
+	class StreamBuffer
+	{
+	public:
+
+		enum class Mode
+		{
+			Persistent,
+			Unsynchronized,
+			Orphan
+		};
+
+		/**
+		 * @param SegmentSize Bytes of each of the three segments, the largest write expected in a frame.
+		 */
+		explicit StreamBuffer(unsigned int SegmentSize);
+
+		~StreamBuffer();
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+		/**
+		 * @brief Reserves size bytes of the ring, waiting for the GPU if it still reads them.
+		 *
+		 * A write stays within one segment, the storage grows when size does not fit in one, which
+		 * replaces the buffer.
+		 *
+		 * @param size Bytes to write.
+		 * @param alignment Alignment of the start of the range, the stride of the data to draw it by instance.
+		 * @return Where to write the data, valid until Commit.
+		 */
+		void* Map(unsigned int size, unsigned int alignment);
+
+		/**
+		 * @brief Makes the data written since Map visible to the GPU.
+		 *
+		 * @return Byte offset of the data in the buffer.
+		 */
+		unsigned int Commit();
+
+		/**
+		 * @brief The buffer to bind, it changes when the storage grows.
+		 */
+		inline const VertexBuffer& Buffer() const { return *m_vb; }
+
+		inline Mode GetMode() const { return m_mode; }
+
+	private:
+		static const unsigned int Segments = 3;
+
+		std::unique_ptr<VertexBuffer> m_vb;
+		Mode m_mode;
+		unsigned int m_SegmentSize;
+		unsigned int m_head;       /// First free byte of the ring.
+		unsigned int m_segment;    /// Segment m_head is in.
+		unsigned int m_MapOffset;  /// Range reserved by the last Map.
+		unsigned int m_MapSize;
+		char* m_persistent;        /// Whole ring when it is persistently mapped.
+		void* m_fences[Segments];
+		std::vector<char> m_staging;
+
+		void Create(unsigned int SegmentSize);
+		void Release();
+	}; // class StreamBuffer
+
+} // namespace Vicetrice
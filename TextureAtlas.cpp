@@ -0,0 +1,158 @@
+#include "TextureAtlas.hpp"
+#include "Backend.hpp"
+#include "Profiler.hpp"
+#include "Shader.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "vendor/imgui/imstb_rectpack.h"
+
+namespace Vicetrice
+{
+	static const unsigned int TexelBytes = 4;
+
+	/**
+	 * @brief Skyline of the packer over the whole MaxHeight, one node per column is enough for any input.
+	 */
+	struct TextureAtlas::Packer
+	{
+		stbrp_context context;
+		std::vector<stbrp_node> nodes;
+
+		Packer(int width, int height)
+			: context{},
+			nodes(static_cast<std::size_t>(width))
+		{
+			stbrp_init_target(&context, width, height, nodes.data(), width);
+		}
+	};
+
+
+	TextureAtlas::TextureAtlas(int width, int height, int MaxHeight)
+		: m_RendererID{ 0 },
+		m_width{ std::max(width, 1) },
+		m_height{ std::clamp(height, 1, std::max(MaxHeight, 1)) },
+		m_MaxHeight{ std::max(MaxHeight, 1) },
+		m_packer{ std::make_unique<Packer>(m_width, m_MaxHeight) },
+		m_rects(1, glm::vec4(0.0f)),
+		m_pixels(static_cast<std::size_t>(m_width) * m_height * TexelBytes, 0),
+		m_block{ static_cast<unsigned int>(MaxImages * sizeof(glm::vec4)) },
+		m_used{ 0 }
+	{
+		// Clamped in release, Upload only grows a texture of at least one row
+		assert(width >= 1 && height >= 1 && height <= MaxHeight);
+
+		Backend& backend = Backend::Get();
+
+		m_RendererID = backend.GenTexture();
+		backend.ActiveTexture(TextureUnit);
+		backend.BindTexture(GL_TEXTURE_2D, m_RendererID);
+
+		// No mipmaps, they would blend neighbouring images
+		backend.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		backend.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		backend.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		backend.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		Allocate();
+
+		// Every entry starts empty, the shaders never read past the images handed out anyway
+		std::vector<glm::vec4> empty(MaxImages, glm::vec4(0.0f));
+		m_block.Update(empty.data(), m_block.Size());
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+		Backend::Get().DeleteTexture(m_RendererID);
+	}
+
+	unsigned int TextureAtlas::Reserve()
+	{
+		if (m_rects.size() == MaxImages)
+			return NoImage;
+
+		m_rects.emplace_back(0.0f);
+		return static_cast<unsigned int>(m_rects.size() - 1);
+	}
+
+	bool TextureAtlas::Upload(unsigned int image, const unsigned char* pixels, int width, int height)
+	{
+		VICE_PROFILE_ZONE("TextureAtlas::Upload");
+
+		// An image is uploaded once, its rectangle is never freed
+		if (image == NoImage || image >= m_rects.size() || m_rects[image].z > m_rects[image].x || width <= 0 || height <= 0)
+			return false;
+
+		stbrp_rect rect = {};
+		rect.w = width;
+		rect.h = height;
+		if (!stbrp_pack_rects(&m_packer->context, &rect, 1))
+			return false;
+
+		Backend& backend = Backend::Get();
+		backend.ActiveTexture(TextureUnit);
+		backend.BindTexture(GL_TEXTURE_2D, m_RendererID);
+
+		// The packer fills the lowest free spot, past the texture it only grows as far as needed
+		int OldHeight = m_height;
+		while (rect.y + height > m_height)
+			m_height = std::min(m_height * 2, m_MaxHeight);
+		if (m_height != OldHeight)
+			m_pixels.resize(static_cast<std::size_t>(m_width) * m_height * TexelBytes, 0);
+
+		std::size_t row = static_cast<std::size_t>(width) * TexelBytes;
+		for (int y = 0; y < height; y++)
+			std::memcpy(&m_pixels[(static_cast<std::size_t>(rect.y + y) * m_width + rect.x) * TexelBytes], pixels + y * row, row);
+
+		if (m_height != OldHeight)
+			Allocate();
+		else
+			backend.TexSubImage2D(GL_TEXTURE_2D, rect.x, rect.y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+		glm::vec4& entry = m_rects[image];
+		entry = glm::vec4(rect.x, rect.y, rect.x + width, rect.y + height);
+		m_block.Update(&entry, sizeof(glm::vec4), image * sizeof(glm::vec4));
+
+		m_used += static_cast<unsigned long long>(width) * height;
+		return true;
+	}
+
+	unsigned int TextureAtlas::Add(const unsigned char* pixels, int width, int height)
+	{
+		unsigned int image = Reserve();
+		if (image == NoImage)
+			return NoImage;
+
+		if (!Upload(image, pixels, width, height))
+		{
+			// Handed back, nothing was handed out after it
+			m_rects.pop_back();
+			return NoImage;
+		}
+
+		return image;
+	}
+
+	void TextureAtlas::Bind() const
+	{
+		Backend& backend = Backend::Get();
+
+		backend.ActiveTexture(TextureUnit);
+		backend.BindTexture(GL_TEXTURE_2D, m_RendererID);
+		m_block.BindRange(BlockBinding, 0, m_block.Size());
+	}
+
+	void TextureAtlas::BindBlock(const Shader& shader)
+	{
+		shader.BindUniformBlock("AtlasBlock", BlockBinding);
+	}
+
+	void TextureAtlas::Allocate()
+	{
+		Backend::Get().TexImage2D(GL_TEXTURE_2D, GL_RGBA8, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "UniformBuffer.hpp"
+#include "vendor/glm/glm.hpp"
+
+namespace Vicetrice
+{
+	class Shader;
+
+	/**
+	 * @brief RGBA8 texture holding many small images, packed as they arrive.
+	 *
+	 * Images are packed by a skyline rectangle packer, lowest position first, so the used part of
+	 * the texture grows downwards and the texture grows with it, doubling its height up to a limit.
+	 * The rectangle of each image, in texels, is kept in AtlasBlock, a uniform block the shaders
+	 * index by image, so every image of every window is drawn with the same texture bind. An image
+	 * can be reserved before its pixels exist: until Upload it has an empty rectangle and the
+	 * shaders draw its quad flat.
+	 *
+	 * Growing the texture re-specifies it, so a copy of the pixels is kept in memory.
+	 */
+	class TextureAtlas
+	{
+	public:
+
+		/**
+		 * @brief Image of nothing, a quad with it is drawn in its color only.
+		 */
+		static const unsigned int NoImage = 0;
+
+		/**
+		 * @brief Entries of AtlasBlock, NoImage included: 16 KB, the smallest block size GL guarantees.
+		 */
+		static const unsigned int MaxImages = 1024;
+
+		/**
+		 * @brief Binding point of AtlasBlock in the shaders that sample the atlas.
+		 */
+		static const unsigned int BlockBinding = 1;
+
+		/**
+		 * @brief Texture unit of u_Atlas, the default value of a sampler uniform.
+		 */
+		static const unsigned int TextureUnit = 0;
+
+		/**
+		 * @param width Width of the texture in texels, images wider than it are never packed. At least 1.
+		 * @param height Height the texture starts with, from 1 to MaxHeight.
+		 * @param MaxHeight Height it grows to at most.
+		 */
+		TextureAtlas(int width, int height, int MaxHeight);
+
+		~TextureAtlas();
+
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+		/**
+		 * @brief Hands out an image with no pixels yet.
+		 *
+		 * @return The image, NoImage when MaxImages are in use.
+		 */
+		unsigned int Reserve();
+
+		/**
+		 * @brief Packs the pixels of a reserved image and uploads them, once.
+		 *
+		 * @param pixels RGBA8 rows, top first.
+		 * @return False if they do not fit or the image already has pixels.
+		 */
+		bool Upload(unsigned int image, const unsigned char* pixels, int width, int height);
+
+		/**
+		 * @brief Reserve and Upload.
+		 *
+		 * @return The image, NoImage if it could not be added.
+		 */
+		unsigned int Add(const unsigned char* pixels, int width, int height);
+
+		/**
+		 * @brief Rectangle of an image in texels: left, top, right and bottom, empty until it is uploaded.
+		 */
+		inline const glm::vec4& Rect(unsigned int image) const { return m_rects[image]; }
+
+		/**
+		 * @brief Binds the texture to TextureUnit and AtlasBlock to BlockBinding.
+		 */
+		void Bind() const;
+
+		/**
+		 * @brief Makes a shader read AtlasBlock from BlockBinding, it must declare the block.
+		 */
+		static void BindBlock(const Shader& shader);
+
+		/**
+		 * @brief Images handed out, NoImage included.
+		 */
+		inline unsigned int Count() const { return static_cast<unsigned int>(m_rects.size()); }
+
+		inline int Width() const { return m_width; }
+		inline int Height() const { return m_height; }
+
+		/**
+		 * @brief Texels covered by the uploaded images.
+		 */
+		inline unsigned long long Used() const { return m_used; }
+
+	private:
+		struct Packer;
+
+		unsigned int m_RendererID;
+		int m_width;
+		int m_height;
+		int m_MaxHeight;
+		std::unique_ptr<Packer> m_packer;
+		std::vector<glm::vec4> m_rects; /// Rectangle of each image, the contents of AtlasBlock.
+		std::vector<unsigned char> m_pixels; /// Copy of the texture, uploaded whole when it grows.
+		UniformBuffer m_block;         /// AtlasBlock.
+		unsigned long long m_used;
+
+		/**
+		 * @brief Allocates the texture at the current height and uploads m_pixels to it.
+		 */
+		void Allocate();
+
+	}; // class TextureAtlas
+
+} // namespace Vicetrice
@@ -0,0 +1,47 @@
+#include "UniformBuffer.hpp"
+#include "Backend.hpp"
+#include "Profiler.hpp"
+#include <GL/glew.h>
+
+namespace Vicetrice
+{
+	UniformBuffer::UniformBuffer(unsigned int size)
+		: m_RendererID{ 0 },
+		m_size{ size }
+	{
+		Backend& backend = Backend::Get();
+
+		m_RendererID = backend.GenBuffer();
+		backend.BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+		backend.BufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	UniformBuffer::~UniformBuffer()
+	{
+		Backend::Get().DeleteBuffer(m_RendererID);
+	}
+
+	void UniformBuffer::Update(const void* data, unsigned int size, unsigned int offset) const
+	{
+		Backend& backend = Backend::Get();
+
+		backend.BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+		backend.BufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+		VICE_PROFILE_COUNT(BufferBytes, size);
+	}
+
+	void UniformBuffer::BindRange(unsigned int binding, unsigned int offset, unsigned int size) const
+	{
+		Backend::Get().BindBufferRange(GL_UNIFORM_BUFFER, binding, m_RendererID, offset, size);
+	}
+
+	unsigned int UniformBuffer::Aligned(unsigned int size)
+	{
+		unsigned int alignment = static_cast<unsigned int>(Backend::Get().UniformBufferOffsetAlignment());
+		if (alignment == 0)
+			return size;
+
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,47 @@
+#pragma once
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Buffer holding std140 uniform blocks, bound by range to a block binding point.
+	 *
+	 * Several blocks can share one buffer, each at an offset that is a multiple of Alignment().
+	 */
+	class UniformBuffer
+	{
+	public:
+
+		/**
+		 * @param size Bytes allocated, the contents are undefined until Update.
+		 */
+		UniformBuffer(unsigned int size);
+
+		~UniformBuffer();
+
+		UniformBuffer(const UniformBuffer&) = delete;
+		UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+		/**
+		 * @brief Writes size bytes at offset.
+		 */
+		void Update(const void* data, unsigned int size, unsigned int offset = 0) const;
+
+		/**
+		 * @brief Makes the blocks bound to binding read size bytes starting at offset.
+		 */
+		void BindRange(unsigned int binding, unsigned int offset, unsigned int size) const;
+
+		/**
+		 * @brief Rounds size up to the offset alignment BindRange requires, the stride of blocks sharing a buffer.
+		 */
+		static unsigned int Aligned(unsigned int size);
+
+		inline unsigned int Size() const { return m_size; }
+
+	private:
+		unsigned int m_RendererID;
+		unsigned int m_size;
+
+	}; // class UniformBuffer
+
+} // namespace Vicetrice
@@ -2,36 +2,66 @@
 #include "VertexBuffer.hpp"
 #include "VertexBufferLayout.hpp"
 #include <GL/glew.h>
-#include "Error.hpp"
+#include "Backend.hpp"
 #include <iostream>
 
 namespace Vicetrice
 {
-	VertexArray::VertexArray()
+	VertexArray::VertexArray() : m_AttribCount{ 0 }
 	{
-		GLCall(glGenVertexArrays(1, &m_RendererID));
+		m_RendererID = Backend::Get().GenVertexArray();
 	}
 
 	VertexArray::~VertexArray()
 	{
 		
-		GLCall(glDeleteVertexArrays(1, &m_RendererID));
+		Backend::Get().DeleteVertexArray(m_RendererID);
 
 	}
 
-	void VertexArray::addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) const
+	unsigned int VertexArray::addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
 	{
 		Bind();
 		vb.Bind();
 		const auto& elements = layout.GetElements();
-		unsigned int offset = 0;
+		unsigned int FirstAttrib = m_AttribCount;
+
+		SetAttribPointers(layout, FirstAttrib, 0);
+
+		for (unsigned int i = 0; i < elements.size(); ++i)
+		{
+			Backend::Get().EnableVertexAttribArray(FirstAttrib + i);
+
+			if (elements[i].divisor != 0)
+			{
+				Backend::Get().VertexAttribDivisor(FirstAttrib + i, elements[i].divisor);
+			}
+		}
+
+		m_AttribCount += static_cast<unsigned int>(elements.size());
+		return FirstAttrib;
+	}
+
+	void VertexArray::SetFirstInstance(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int FirstAttrib, unsigned int FirstInstance) const
+	{
+		Bind();
+		vb.Bind();
+		SetAttribPointers(layout, FirstAttrib, FirstInstance * layout.GetStride());
+	}
+
+	void VertexArray::SetAttribPointers(const VertexBufferLayout& layout, unsigned int FirstAttrib, unsigned int BaseOffset) const
+	{
+		const auto& elements = layout.GetElements();
+		unsigned int offset = BaseOffset;
 		// define vertex position layout
-		// This links the attrib pointer wih the buffer at index 0 in the vertex array object
+		// This links the attrib pointer wih the buffer bound to GL_ARRAY_BUFFER in the vertex array object
 		for (unsigned int i = 0; i < elements.size(); ++i)
 		{
 			const auto& element = elements[i];
-			GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
-			GLCall(glEnableVertexAttribArray(i));
+			if (element.integer != GL_FALSE)
+				Backend::Get().VertexAttribIPointer(FirstAttrib + i, element.count, element.type, layout.GetStride(), offset);
+			else
+				Backend::Get().VertexAttribPointer(FirstAttrib + i, element.count, element.type, element.normalized != GL_FALSE, layout.GetStride(), offset);
 
 			offset += element.count * VertexBufferElement::GetSizeofType(element.type);
 		}
@@ -39,11 +69,11 @@ namespace Vicetrice
 
 	void VertexArray::Bind() const
 	{
-		GLCall(glBindVertexArray(m_RendererID));
+		Backend::Get().BindVertexArray(m_RendererID);
 	}
 
 	void VertexArray::Unbind() const
 	{
-		GLCall(glBindVertexArray(0));
+		Backend::Get().BindVertexArray(0);
 	}
 } //namespace Vicetrice
\ No newline at end of file
@@ -12,7 +12,18 @@ namespace Vicetrice
 		VertexArray();
 		~VertexArray();
 
-		void addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) const;
+		/**
+		*	@brief Links the buffer to the next free attribute locations of the VAO
+		*	@return location of the first attribute of the buffer
+		*/
+		unsigned int addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+
+		/**
+		*	@brief Points the per-instance attributes of a buffer at another instance, GL 3.3 has no base instance draws
+		*	@param FirstAttrib location returned by addBuffer for this buffer
+		*	@param FirstInstance instance read by the first drawn instance
+		*/
+		void SetFirstInstance(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int FirstAttrib, unsigned int FirstInstance) const;
 
 		void Bind() const;
 
@@ -20,6 +31,9 @@ namespace Vicetrice
 
 	private:
 		unsigned int m_RendererID;
+		unsigned int m_AttribCount;
+
+		void SetAttribPointers(const VertexBufferLayout& layout, unsigned int FirstAttrib, unsigned int BaseOffset) const;
 
 	}; //class VertexArray
 } //namespace Vicetrice
\ No newline at end of file
@@ -1,43 +1,52 @@
 #include "VertexBuffer.hpp"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
-#include "Error.hpp"
+#include "Backend.hpp"
+#include "Profiler.hpp"
 
 
 namespace Vicetrice
 {
 	VertexBuffer::VertexBuffer(const void* data, unsigned int size)
 	{
-		GLCall(glGenBuffers(1, &m_RendererID));
+		m_RendererID = Backend::Get().GenBuffer();
 
 
-		GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+		Backend::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 
 
-		GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW));
+		Backend::Get().BufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
 
 	}
 
 	VertexBuffer::~VertexBuffer()
 	{
-		GLCall(glDeleteBuffers(1, &m_RendererID));
+		Backend::Get().DeleteBuffer(m_RendererID);
 	}
 
 	void VertexBuffer::Bind() const
 	{
-		GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+		Backend::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 	}
 
 	void VertexBuffer::Unbind() const
 	{
-		GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		Backend::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
 
 	}
 
 	void VertexBuffer::Update(const void* data, unsigned int size, unsigned int offset) const
 	{
 		Bind();
-		GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+		Backend::Get().BufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+		VICE_PROFILE_COUNT(BufferBytes, size);
+	}
+
+	void VertexBuffer::Allocate(const void* data, unsigned int size) const
+	{
+		Bind();
+		Backend::Get().BufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+		VICE_PROFILE_COUNT(BufferBytes, size);
 	}
 
 
@@ -16,6 +16,8 @@ namespace Vicetrice
 		void Unbind() const;
 		// Mtodo para actualizar el contenido del buffer
 		void Update(const void* data, unsigned int size, unsigned int offset = 0) const;
+		// Reallocates the buffer storage, previous contents are discarded
+		void Allocate(const void* data, unsigned int size) const;
 
 
 	private:
@@ -13,7 +13,7 @@ namespace Vicetrice
 	template <>
 	void VertexBufferLayout::Push<float>(unsigned int cont)
 	{
-		m_Elements.push_back({ GL_FLOAT,cont,GL_FALSE });
+		m_Elements.push_back({ GL_FLOAT,cont,GL_FALSE,m_Divisor,GL_FALSE });
 		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_FLOAT);
 	}
 
@@ -25,7 +25,7 @@ namespace Vicetrice
 	template<>
 	void VertexBufferLayout::Push<unsigned int>(unsigned int cont)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_INT,cont,GL_FALSE });
+		m_Elements.push_back({ GL_UNSIGNED_INT,cont,GL_FALSE,m_Divisor,GL_FALSE });
 		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_UNSIGNED_INT);
 
 	}
@@ -38,9 +38,58 @@ namespace Vicetrice
 	template<>
 	void VertexBufferLayout::Push<unsigned char>(unsigned int cont)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE,cont,GL_TRUE });
+		m_Elements.push_back({ GL_UNSIGNED_BYTE,cont,GL_TRUE,m_Divisor,GL_FALSE });
 		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_UNSIGNED_BYTE);
 
 	}
 
+
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout, normalized to [-1, 1]
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::Push<short>(unsigned int cont)
+	{
+		m_Elements.push_back({ GL_SHORT,cont,GL_TRUE,m_Divisor,GL_FALSE });
+		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_SHORT);
+	}
+
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::Push<HalfFloat>(unsigned int cont)
+	{
+		m_Elements.push_back({ GL_HALF_FLOAT,cont,GL_FALSE,m_Divisor,GL_FALSE });
+		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_HALF_FLOAT);
+	}
+
+
+	/**
+	*	@brief Recieve the number of integer elements, the shader input is a uint
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::PushInteger<unsigned int>(unsigned int cont)
+	{
+		m_Elements.push_back({ GL_UNSIGNED_INT,cont,GL_FALSE,m_Divisor,GL_TRUE });
+		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_UNSIGNED_INT);
+	}
+
+
+	/**
+	*	@brief Recieve the number of integer elements, the shader input is an int
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::PushInteger<int>(unsigned int cont)
+	{
+		m_Elements.push_back({ GL_INT,cont,GL_FALSE,m_Divisor,GL_TRUE });
+		m_Stride += cont * VertexBufferElement::GetSizeofType(GL_INT);
+	}
+
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include <GL/glew.h>
 #include <cassert>
 
@@ -8,11 +9,21 @@
 
 namespace Vicetrice
 {
+	/**
+	*	@brief 16-bit float as stored in a vertex buffer, see glm::packHalf1x16
+	*/
+	struct HalfFloat
+	{
+		std::uint16_t bits;
+	};
+
 	struct VertexBufferElement
 	{
 		unsigned int type;
 		unsigned int count;
 		unsigned char normalized;
+		unsigned int divisor;   // 0 for per-vertex data, N to advance once every N instances
+		unsigned char integer;  // GL_TRUE to read the values as integers (glVertexAttribIPointer), the shader input is int or uint
 
 
 		static unsigned int GetSizeofType(unsigned int type)
@@ -21,7 +32,10 @@ namespace Vicetrice
 			{
 			case GL_FLOAT:return 4;
 			case GL_UNSIGNED_INT:return 4;
+			case GL_INT:return 4;
 			case GL_UNSIGNED_BYTE:return 1;
+			case GL_SHORT:return 2;
+			case GL_HALF_FLOAT:return 2;
 
 			}
 			assert(false);
@@ -33,7 +47,13 @@ namespace Vicetrice
 	{
 	public:
 
-		VertexBufferLayout() : m_Stride{ 0 } {}
+		VertexBufferLayout() : m_Stride{ 0 }, m_Divisor{ 0 } {}
+
+		/**
+		*	@brief Layout whose elements are per-instance attributes
+		*	@param divisor number of instances drawn before the attributes advance
+		*/
+		explicit VertexBufferLayout(unsigned int divisor) : m_Stride{ 0 }, m_Divisor{ divisor } {}
 
 
 		/**
@@ -43,41 +63,87 @@ namespace Vicetrice
 		template <typename T>
 		inline void Push(unsigned int cont)
 		{
-			static_assert(false);
+			static_assert(sizeof(T) == 0, "Unsupported vertex attribute type");
 		}
 
-
 		/**
-		*	@brief Recieve the number of elements that fill the layout
-		*	@param cont number of elements to be added in the VAO
-		*/
-		template <>
-		void Push<float>(unsigned int cont);
-
-
-		/**
-		*	@brief Recieve the number of elements that fill the layout
-		*	@param cont number of elements to be added in the VAO
-		*/
-		template<>
-		void Push<unsigned int>(unsigned int cont);
-
-
-		/**
-		*	@brief Recieve the number of elements that fill the layout
+		*	@brief Recieve the number of integer elements, the shader reads them unconverted
 		*	@param cont number of elements to be added in the VAO
 		*/
-		template<>
-		void Push<unsigned char>(unsigned int cont);
+		template <typename T>
+		inline void PushInteger(unsigned int cont)
+		{
+			static_assert(sizeof(T) == 0, "Unsupported integer vertex attribute type");
+		}
 
 
-		inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
+		inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
 		inline unsigned int GetStride() const { return m_Stride; };
+		inline unsigned int GetDivisor() const { return m_Divisor; };
 
 	private:
 		std::vector <VertexBufferElement> m_Elements;
 		unsigned int m_Stride;
+		unsigned int m_Divisor;
 	}; //class VertexBufferLayout
+
+
+	// Explicit specializations must live at namespace scope, they are defined in VertexBufferLayout.cpp
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template <>
+	void VertexBufferLayout::Push<float>(unsigned int cont);
+
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::Push<unsigned int>(unsigned int cont);
+
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::Push<unsigned char>(unsigned int cont);
+
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout, normalized to [-1, 1]
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::Push<short>(unsigned int cont);
+
+
+	/**
+	*	@brief Recieve the number of elements that fill the layout
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::Push<HalfFloat>(unsigned int cont);
+
+
+	/**
+	*	@brief Recieve the number of integer elements, the shader input is a uint
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::PushInteger<unsigned int>(unsigned int cont);
+
+
+	/**
+	*	@brief Recieve the number of integer elements, the shader input is an int
+	*	@param cont number of elements to be added in the VAO
+	*/
+	template<>
+	void VertexBufferLayout::PushInteger<int>(unsigned int cont);
 } //namespace Vicetrice
 
 
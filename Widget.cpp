@@ -0,0 +1,241 @@
+#include "Widget.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Vicetrice
+{
+	static const float ShapeTolerance = 1.0f / 256.0f; // pixels, moving a box with the root rounds its corners by less
+
+	/**
+	 * @brief Checks if two rectangles are the same relative to their origins, rounding aside.
+	 */
+	static bool SameShape(const LayoutRect& a, const glm::vec2& OriginA, const LayoutRect& b, const glm::vec2& OriginB)
+	{
+		return std::abs((a.left - OriginA.x) - (b.left - OriginB.x)) < ShapeTolerance &&
+			std::abs((a.top - OriginA.y) - (b.top - OriginB.y)) < ShapeTolerance &&
+			std::abs((a.right - OriginA.x) - (b.right - OriginB.x)) < ShapeTolerance &&
+			std::abs((a.bottom - OriginA.y) - (b.bottom - OriginB.y)) < ShapeTolerance;
+	}
+
+	//---------------------------------------- Widget
+
+	Widget::Widget(WidgetTree& tree, Widget* parent, const LayoutStyle& style)
+		: m_tree{ tree },
+		m_parent{ parent },
+		m_box{ tree.GetLayout().Add(parent != nullptr ? parent->m_box : Layout::Root, style) },
+		m_children{},
+		m_rect{},
+		m_content{},
+		m_version{ ~0ull },
+		m_origin{ 0.0f },
+		m_dirty{ Clean },
+		m_batch{}
+	{
+		// The siblings make room for the new box
+		if (m_parent != nullptr)
+			m_parent->MarkDirty(Relayout);
+
+		MarkDirty(Repaint);
+	}
+
+	const LayoutStyle& Widget::Style() const
+	{
+		return m_tree.GetLayout().Style(m_box);
+	}
+
+	void Widget::SetStyle(const LayoutStyle& style)
+	{
+		if (!m_tree.GetLayout().SetStyle(m_box, style))
+			return;
+
+		// The size and margin place the siblings, the padding and direction the children
+		MarkDirty(Relayout);
+		if (m_parent != nullptr)
+			m_parent->MarkDirty(Relayout);
+	}
+
+	void Widget::SetSize(LayoutSize size)
+	{
+		LayoutStyle style = Style();
+		style.size = size;
+		SetStyle(style);
+	}
+
+	void Widget::Invalidate()
+	{
+		MarkDirty(Repaint);
+	}
+
+	unsigned int Widget::BatchInstances() const
+	{
+		unsigned int count = static_cast<unsigned int>(m_batch.size() / WidgetTree::BatchFloats);
+		for (const std::unique_ptr<Widget>& child : m_children)
+			count += child->BatchInstances();
+
+		return count;
+	}
+
+	float* Widget::WriteBatch(float* out) const
+	{
+		out = m_tree.WriteRects(m_batch, out);
+		for (const std::unique_ptr<Widget>& child : m_children)
+			out = child->WriteBatch(out);
+
+		return out;
+	}
+
+	void Widget::Tessellate(std::vector<float>&) const
+	{
+	}
+
+	void Widget::MarkDirty(unsigned char flags)
+	{
+		m_dirty |= flags;
+
+		// An ancestor that already has a dirty child has marked the ones above it too
+		for (Widget* ancestor = m_parent; ancestor != nullptr && !(ancestor->m_dirty & DirtyChild); ancestor = ancestor->m_parent)
+			ancestor->m_dirty |= DirtyChild;
+	}
+
+	unsigned int Widget::Update(bool moved)
+	{
+		if (!moved && m_dirty == Clean)
+			return 0;
+
+		const Layout& layout = m_tree.GetLayout();
+		bool placed = false;
+		if (layout.Version(m_box) != m_version)
+		{
+			const LayoutRect& rect = layout.Rect(m_box);
+			const LayoutRect& content = layout.Content(m_box);
+			glm::vec2 origin = m_tree.Origin();
+
+			// The rectangles are relative to the root, a box that only moved along with it keeps them
+			if (!SameShape(rect, origin, m_rect, m_origin) || !SameShape(content, origin, m_content, m_origin))
+				m_dirty |= Repaint;
+
+			m_version = layout.Version(m_box);
+			m_rect = rect;
+			m_content = content;
+			m_origin = origin;
+			placed = true;
+		}
+
+		unsigned int tessellated = 0;
+		if ((m_dirty & Repaint) && m_tree.Batched())
+		{
+			m_batch.clear();
+			Tessellate(m_batch);
+			tessellated = 1;
+		}
+
+		// The children of a box that was placed or arranged again have new versions
+		bool arranged = placed || (m_dirty & Relayout) != 0;
+		bool below = arranged || (m_dirty & DirtyChild) != 0;
+		m_dirty = Clean;
+
+		if (below)
+		{
+			for (const std::unique_ptr<Widget>& child : m_children)
+				tessellated += child->Update(arranged);
+		}
+
+		return tessellated;
+	}
+
+
+	//---------------------------------------- Panel
+
+	Panel::Panel(WidgetTree& tree, Widget* parent, const LayoutStyle& style, const glm::vec4& color)
+		: Widget{ tree, parent, style },
+		m_color{ color }
+	{
+	}
+
+	void Panel::SetColor(const glm::vec4& color)
+	{
+		if (color == m_color)
+			return;
+
+		m_color = color;
+		Invalidate();
+	}
+
+	void Panel::Tessellate(std::vector<float>& batch) const
+	{
+		if (m_color.a > 0.0f)
+			m_tree.AddRect(batch, Rect(), m_color, Rect());
+	}
+
+
+	//---------------------------------------- WidgetTree
+
+	WidgetTree::WidgetTree(int ContextWidth, int ContextHeight, bool batched, const LayoutStyle& style)
+		: m_layout{},
+		m_bounds{},
+		m_ContextWidth{ ContextWidth },
+		m_ContextHeight{ ContextHeight },
+		m_batched{ batched },
+		m_root{},
+		m_tessellations{ 0 }
+	{
+		m_root = std::make_unique<Panel>(*this, nullptr, style);
+	}
+
+	void WidgetTree::Update()
+	{
+		// A root that moved has a new version, the walk then reaches every widget
+		bool moved = m_layout.Update(m_bounds);
+		m_tessellations += m_root->Update(moved);
+	}
+
+	void WidgetTree::AddRect(std::vector<float>& batch, const LayoutRect& rect, const glm::vec4& color, const LayoutRect& clip, unsigned int image) const
+	{
+		glm::vec2 origin = Origin();
+		const float record[BatchFloats] =
+		{
+			rect.left - origin.x, rect.top - origin.y, rect.right - origin.x, rect.bottom - origin.y,
+			color.r, color.g, color.b, color.a,
+			clip.left - origin.x, clip.top - origin.y, clip.right - origin.x, clip.bottom - origin.y,
+			static_cast<float>(image)
+		};
+
+		batch.insert(batch.end(), record, record + BatchFloats);
+	}
+
+	glm::vec2 WidgetTree::Origin() const
+	{
+		const LayoutRect& root = m_layout.Rect(Layout::Root);
+		return glm::vec2(root.left, root.top);
+	}
+
+	float* WidgetTree::WriteRects(const std::vector<float>& batch, float* out) const
+	{
+		// x and y of a record are relative to the root, NDC = offset + scale * pixels with y going up
+		glm::vec2 origin = Origin();
+		float sx = 2.0f / m_ContextWidth;
+		float sy = -2.0f / m_ContextHeight;
+		float ox = sx * origin.x - 1.0f;
+		float oy = sy * origin.y + 1.0f;
+
+		for (std::size_t i = 0; i < batch.size(); i += BatchFloats)
+		{
+			const float* record = &batch[i];
+
+			// left, top, right, bottom of the rect and of the clip become left, bottom, right, top
+			for (unsigned int rect : { 0u, 8u })
+			{
+				out[rect + 0] = ox + sx * record[rect + 0];
+				out[rect + 1] = oy + sy * record[rect + 3];
+				out[rect + 2] = ox + sx * record[rect + 2];
+				out[rect + 3] = oy + sy * record[rect + 1];
+			}
+			std::copy_n(record + 4, 4, out + 4);
+			out[12] = record[12];
+			out += BatchFloats;
+		}
+
+		return out;
+	}
+
+} // namespace Vicetrice
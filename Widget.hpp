@@ -0,0 +1,273 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Layout.hpp"
+#include "TextureAtlas.hpp"
+#include "vendor/glm/glm.hpp"
+
+namespace Vicetrice
+{
+	class WidgetTree;
+
+	/**
+	 * @brief Node of a WidgetTree: a box of its Layout that caches its geometry and the rectangles it is drawn with.
+	 *
+	 * A widget that changes marks itself dirty and its ancestors as holding a dirty child, so an Update
+	 * only walks down to what changed. The rectangles of a widget are kept relative to the root and
+	 * written again (tessellated) only when it asks for it or when its box changed shape, so a tree
+	 * that just moved keeps every rectangle it cached.
+	 */
+	class Widget
+	{
+	public:
+
+		/**
+		 * @brief Adds the widget as the last child of parent, nullptr for the root of the tree.
+		 */
+		Widget(WidgetTree& tree, Widget* parent, const LayoutStyle& style);
+
+		virtual ~Widget() = default;
+
+		Widget(const Widget&) = delete;
+		Widget& operator=(const Widget&) = delete;
+
+		/**
+		 * @brief Creates a child, stacked after the ones added before.
+		 *
+		 * @return The child, owned by this widget.
+		 */
+		template <typename T, typename... Args>
+		T& Add(const LayoutStyle& style, Args&&... args)
+		{
+			m_children.push_back(std::make_unique<T>(m_tree, this, style, std::forward<Args>(args)...));
+			return static_cast<T&>(*m_children.back());
+		}
+
+		inline Widget* Parent() const { return m_parent; }
+
+		/**
+		 * @brief Box of the widget in the Layout of its tree.
+		 */
+		inline unsigned int Box() const { return m_box; }
+
+		/**
+		 * @brief Border box at the last Update of the tree, in pixels of the context.
+		 */
+		inline const LayoutRect& Rect() const { return m_rect; }
+
+		/**
+		 * @brief Content box at the last Update of the tree, in pixels of the context.
+		 */
+		inline const LayoutRect& Content() const { return m_content; }
+
+		const LayoutStyle& Style() const;
+
+		/**
+		 * @brief Changes the style, the next Update arranges the parent again.
+		 */
+		void SetStyle(const LayoutStyle& style);
+
+		/**
+		 * @brief Changes the size along the direction of the parent.
+		 */
+		void SetSize(LayoutSize size);
+
+		/**
+		 * @brief Asks for the rectangles of this widget to be written again at the next Update.
+		 */
+		void Invalidate();
+
+		/**
+		 * @brief Rectangles cached for this widget and its children.
+		 */
+		unsigned int BatchInstances() const;
+
+		/**
+		 * @brief Writes the cached rectangles of this widget and then of its children in NDC, back to front.
+		 *
+		 * @param out Room for BatchInstances() * WidgetTree::BatchFloats floats.
+		 * @return One past the last float written.
+		 */
+		float* WriteBatch(float* out) const;
+
+	protected:
+		WidgetTree& m_tree;
+
+		/**
+		 * @brief Appends the rectangles of the widget with WidgetTree::AddRect, nothing by default.
+		 *
+		 * Called by Update with Rect() and Content() already current, and again only when either changes shape.
+		 */
+		virtual void Tessellate(std::vector<float>& batch) const;
+
+	private:
+		friend class WidgetTree;
+
+		enum Flags : unsigned char
+		{
+			Clean = 0,
+			Repaint = 1,       /// The rectangles must be written again.
+			Relayout = 2,      /// The style changed, the boxes under the parent may have moved.
+			DirtyChild = 4     /// A widget below is dirty.
+		};
+
+		Widget* m_parent;
+		unsigned int m_box;
+		std::vector<std::unique_ptr<Widget>> m_children;
+		LayoutRect m_rect;
+		LayoutRect m_content;
+		unsigned long long m_version;  /// Layout::Version of the box when m_rect was read.
+		glm::vec2 m_origin;            /// Top left corner of the root when m_rect was read.
+		unsigned char m_dirty;
+		std::vector<float> m_batch;    /// Rectangles of the last Tessellate.
+
+		/**
+		 * @brief Sets flags and marks the ancestors, up to the first one that already knew.
+		 */
+		void MarkDirty(unsigned char flags);
+
+		/**
+		 * @brief Reads the geometry of the dirty widgets and of the ones whose box moved, and tessellates
+		 * the ones that asked for it or changed shape.
+		 *
+		 * @param moved The box of the parent moved or its children were arranged again.
+		 * @return Widgets tessellated.
+		 */
+		unsigned int Update(bool moved);
+
+	}; // class Widget
+
+
+	/**
+	 * @brief Widget that fills its box with a color, a transparent one only groups its children.
+	 */
+	class Panel : public Widget
+	{
+	public:
+		Panel(WidgetTree& tree, Widget* parent, const LayoutStyle& style, const glm::vec4& color = glm::vec4(0.0f));
+
+		inline const glm::vec4& Color() const { return m_color; }
+
+		void SetColor(const glm::vec4& color);
+
+	protected:
+		void Tessellate(std::vector<float>& batch) const override;
+
+	private:
+		glm::vec4 m_color;
+
+	}; // class Panel
+
+
+	/**
+	 * @brief Retained tree of widgets laid out in one rectangle of a context.
+	 *
+	 * The tree owns the Layout of its widgets and the root, a Panel. Changes to the widgets are
+	 * collected until Update, which lays out the boxes that changed and tessellates only the widgets
+	 * that asked for it or changed shape. The cached rectangles are in pixels from the top left corner
+	 * of the root, WriteBatch places them in NDC.
+	 */
+	class WidgetTree
+	{
+	public:
+
+		/**
+		 * @brief Floats of each rectangle WriteBatch writes: rect (left, bottom, right, top), color and clip rect, in NDC, and image.
+		 */
+		static const unsigned int BatchFloats = 13;
+
+		/**
+		 * @param ContextWidth Width of the context, in pixels.
+		 * @param ContextHeight Height of the context, in pixels.
+		 * @param batched False when nothing reads WriteBatch, the widgets are then laid out but never tessellated.
+		 * @param style Style of the root panel.
+		 */
+		WidgetTree(int ContextWidth, int ContextHeight, bool batched = true, const LayoutStyle& style = LayoutStyle());
+
+		WidgetTree(const WidgetTree&) = delete;
+		WidgetTree& operator=(const WidgetTree&) = delete;
+
+		inline Panel& Root() { return *m_root; }
+		inline const Panel& Root() const { return *m_root; }
+
+		inline Layout& GetLayout() { return m_layout; }
+		inline const Layout& GetLayout() const { return m_layout; }
+
+		/**
+		 * @brief Places the root, in pixels of the context.
+		 */
+		inline void SetBounds(const LayoutRect& bounds) { m_bounds = bounds; }
+
+		inline const LayoutRect& Bounds() const { return m_bounds; }
+
+		/**
+		 * @brief Changes the size of the context, nothing is tessellated again.
+		 */
+		inline void SetContextSize(int ContextWidth, int ContextHeight)
+		{
+			m_ContextWidth = ContextWidth;
+			m_ContextHeight = ContextHeight;
+		}
+
+		inline int ContextWidth() const { return m_ContextWidth; }
+		inline int ContextHeight() const { return m_ContextHeight; }
+
+		inline bool Batched() const { return m_batched; }
+
+		/**
+		 * @brief Lays out the boxes that changed and tessellates the widgets that need it.
+		 */
+		void Update();
+
+		/**
+		 * @brief Rectangles WriteBatch writes.
+		 */
+		inline unsigned int BatchInstances() const { return m_root->BatchInstances(); }
+
+		/**
+		 * @brief Writes the rectangles of every widget in NDC, back to front.
+		 */
+		inline float* WriteBatch(float* out) const { return m_root->WriteBatch(out); }
+
+		/**
+		 * @brief Appends a rectangle for the batch shader, kept relative to the root until WriteBatch.
+		 *
+		 * @param rect In pixels of the context.
+		 * @param clip In pixels of the context, the parts of rect outside of it are not drawn.
+		 * @param image TextureAtlas image stretched over rect and tinted by color, NoImage fills it with color.
+		 */
+		void AddRect(std::vector<float>& batch, const LayoutRect& rect, const glm::vec4& color, const LayoutRect& clip, unsigned int image = TextureAtlas::NoImage) const;
+
+		/**
+		 * @brief Widgets tessellated over every Update.
+		 */
+		inline unsigned long long Tessellations() const { return m_tessellations; }
+
+	private:
+		friend class Widget;
+
+		Layout m_layout;
+		LayoutRect m_bounds;
+		int m_ContextWidth;
+		int m_ContextHeight;
+		bool m_batched;
+		std::unique_ptr<Panel> m_root;
+		unsigned long long m_tessellations;
+
+		/**
+		 * @brief Top left corner of the root, in pixels of the context.
+		 */
+		glm::vec2 Origin() const;
+
+		/**
+		 * @brief Writes rectangles added with AddRect in NDC, at the current position of the root.
+		 *
+		 * @return One past the last float written.
+		 */
+		float* WriteRects(const std::vector<float>& batch, float* out) const;
+
+	}; // class WidgetTree
+
+} // namespace Vicetrice
@@ -3,8 +3,14 @@
 #include "Window.hpp"
 #include "IndexBuffer.hpp"
 #include "Shader.hpp"
+#include "ShaderCache.hpp"
+#include "CursorCache.hpp"
+#include "UniformBuffer.hpp"
+#include "TextureAtlas.hpp"
 #include "VertexArray.hpp"
-#include <iostream>
+#include "Backend.hpp"
+#include "Profiler.hpp"
+#include "vendor/glm/gtc/packing.hpp"
 #include <string>
 
 
@@ -12,15 +18,224 @@
 #include <unordered_map>
 #include <memory>
 #include <random>
-#include <chrono>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <cmath>
+#include <cstring>
 
 
 
 namespace Vicetrice
 {
-	static const float epsilon = 0.01f;
-	static const unsigned int VerticesPerIcon = 12;
 	static const unsigned int IndicesPerIcon = 6;
+	static const unsigned int FirstRowInstance = 1;  // Each write to the instance stream starts with the slider
+	static const unsigned int VerticesPerWindow = 4;
+	static const unsigned int FloatsPerVertex = 7;   // Position, color and id of one vertex of m_vertex
+
+	static const float UnitQuad[] =
+	{
+		//Position
+		0.0f, 0.0f,	// LD
+		1.0f, 0.0f,	// RD
+		1.0f, 1.0f,	// RU
+		0.0f, 1.0f	// LU
+	};
+
+	// Metrics of the window, in pixels of the context
+	static const float RowHeight = 32.0f;
+	static const float HeaderHeight = 32.0f;         // Strip above the rows where the window is grabbed
+	static const float SliderWidth = 20.0f;          // Track of the slider, right of the rows
+	static const float ThumbInset = 4.0f;            // Between each side of the track and the thumb
+	static const float MinThumbHeight = 24.0f;
+	static const float BorderGrab = 4.0f;            // Distance to an edge that still grabs it for resizing
+	static const float MinWidth = 64.0f;
+	static const float MinHeight = HeaderHeight + RowHeight;
+	static const glm::vec4 LabelColor(0.1f, 0.1f, 0.1f, 1.0f);
+
+	// The diagonal resize cursors are new in GLFW 3.4, the corners show the arrow before it
+#if GLFW_VERSION_MAJOR > 3 || GLFW_VERSION_MINOR >= 4
+	static const int NWSEResizeCursor = GLFW_RESIZE_NWSE_CURSOR;
+	static const int NESWResizeCursor = GLFW_RESIZE_NESW_CURSOR;
+#else
+	static const int NWSEResizeCursor = GLFW_ARROW_CURSOR;
+	static const int NESWResizeCursor = GLFW_ARROW_CURSOR;
+#endif
+
+	static const unsigned int InstanceStreamSegment = 64 * 1024; // bytes, many writes of the visible rows fit in a segment
+	static const int DamagePadding = 1;              // pixels around a damaged rectangle, covers the rasterization of its edges
+	static const unsigned int WindowBlockBinding = 0; // Binding point of WindowBlock in Window.shader and Icon.shader
+
+	/**
+	 * @brief WindowBlock of Window.shader and Icon.shader, std140.
+	 */
+	struct DrawBlock
+	{
+		glm::mat4 M;
+		float WinLimit[4];
+	};
+
+	// One DrawBlock per draw of a window, at multiples of the uniform buffer alignment
+	enum DrawBlockIndex : unsigned int { WindowDraw = 0, RowsDraw = 1, SliderDraw = 2, DrawBlocks = 3 };
+
+	/**
+	 * @brief Vertex of the window quad as Window.shader reads it, 12 bytes.
+	 */
+	struct WindowVertex
+	{
+		HalfFloat position[2];
+		std::uint8_t color[4];
+		std::uint32_t id;
+	};
+
+	static_assert(sizeof(WindowVertex) == 12, "WindowVertex must match the layout of the window quad");
+
+	/**
+	 * @brief Packs the float vertices of a window into the format of its vertex buffer.
+	 */
+	static std::array<WindowVertex, VerticesPerWindow> PackVertices(const std::vector<float>& vertex)
+	{
+		std::array<WindowVertex, VerticesPerWindow> packed;
+
+		for (unsigned int i = 0; i < VerticesPerWindow; i++)
+		{
+			const float* source = &vertex[i * FloatsPerVertex];
+
+			packed[i].position[0].bits = glm::packHalf1x16(source[0]);
+			packed[i].position[1].bits = glm::packHalf1x16(source[1]);
+			for (int c = 0; c < 4; c++)
+				packed[i].color[c] = PackUnorm8(source[2 + c]);
+			packed[i].id = static_cast<std::uint32_t>(source[6]);
+		}
+
+		return packed;
+	}
+
+	// Row -1 leaves the unit quad untouched, SliderMatrix places it on the thumb
+	static const IconInstance SliderInstance = { -1, { 255, 255, 255, 255 }, TextureAtlas::NoImage };
+
+	/**
+	 * @brief Writes a rectangle of the context as clip limits of the icon shader: right, left, top and bottom in gl_FragCoord pixels.
+	 */
+	static void ClipLimits(const LayoutRect& rect, int ContextHeight, float* out)
+	{
+		out[0] = rect.right;
+		out[1] = rect.left;
+		out[2] = static_cast<float>(ContextHeight) - rect.top;
+		out[3] = static_cast<float>(ContextHeight) - rect.bottom;
+	}
+
+
+	/**
+	 * @brief GL objects a standalone window draws itself with.
+	 */
+	struct Window::Resources
+	{
+		// Window
+		VertexArray m_va;              /// Vertex array object for the window.
+		VertexBuffer m_vb;             /// Vertex buffer object for the window.
+		std::shared_ptr<Shader> m_shader; /// Window shader, shared with the other windows.
+		IndexBuffer m_ib;              /// Index buffer object for the window.
+
+		// Icons
+		VertexArray m_vaI;             /// Vertex array object for the icons.
+		VertexBuffer m_vbI;            /// Unit quad shared by every icon instance.
+		std::shared_ptr<Shader> m_shaderI; /// Icon shader, shared with the other windows.
+		IndexBuffer m_ibI;             /// Index buffer object for the unit quad.
+		StreamBuffer m_InstanceStream; /// Per-instance data (row, color, image) of the slider and the visible rows, rewritten when they change.
+		VertexBufferLayout m_InstanceLayout; /// Layout of the per-instance data.
+		unsigned int m_InstanceAttrib; /// Location of the first per-instance attribute in m_vaI.
+		UniformHandle m_FirstRow;      /// u_FirstRow of the icon shader.
+		UniformHandle m_RowAspect;     /// u_RowAspect of the icon shader.
+
+		// Uniforms
+		unsigned int m_BlockStride;    /// Bytes between two DrawBlocks in m_blocks.
+		UniformBuffer m_blocks;        /// WindowBlock of the window, the rows and the slider.
+		DrawBlock m_uploaded[DrawBlocks]; /// What m_blocks holds, nothing is uploaded while it matches.
+		std::vector<unsigned char> m_BlockData; /// Staging copy of m_blocks, with the padding between blocks.
+
+		Resources(const Window& window)
+			: m_va{},
+			m_vb{ PackVertices(window.m_vertex).data(), VerticesPerWindow * sizeof(WindowVertex) },
+			m_shader{ ShaderCache::Get("res/shaders/Window.shader") },
+			m_ib{ window.m_indices.data(), static_cast<unsigned int>(sizeof(unsigned int) * window.m_indices.size()) },
+			m_vaI{},
+			m_vbI{ UnitQuad, sizeof(UnitQuad) },
+			m_shaderI{ ShaderCache::Get("res/shaders/Icon.shader") },
+			m_ibI{ IndexBuffer::QuadPattern(1).data(), IndicesPerIcon * sizeof(unsigned int) },
+			m_InstanceStream{ InstanceStreamSegment },
+			m_InstanceLayout{ 1 },
+			m_InstanceAttrib{ 0 },
+			m_FirstRow{ m_shaderI->Uniform("u_FirstRow") },
+			m_RowAspect{ m_shaderI->Uniform("u_RowAspect") },
+			m_BlockStride{ UniformBuffer::Aligned(sizeof(DrawBlock)) },
+			m_blocks{ DrawBlocks * m_BlockStride },
+			m_uploaded{},
+			m_BlockData(DrawBlocks * m_BlockStride)
+		{
+			VertexBufferLayout layout;
+
+			// WindowVertex
+			layout.Push<HalfFloat>(2);
+			layout.Push<unsigned char>(4);
+			layout.PushInteger<unsigned int>(1);
+
+			m_va.addBuffer(m_vb, layout);
+
+			VertexBufferLayout QuadLayout;
+
+			QuadLayout.Push<float>(2);
+
+			// IconInstance
+			m_InstanceLayout.PushInteger<int>(1);
+			m_InstanceLayout.Push<unsigned char>(4);
+			m_InstanceLayout.PushInteger<unsigned int>(1);
+
+			m_vaI.addBuffer(m_vbI, QuadLayout);
+			m_InstanceAttrib = m_vaI.addBuffer(m_InstanceStream.Buffer(), m_InstanceLayout);
+
+			m_shader->BindUniformBlock("WindowBlock", WindowBlockBinding);
+			m_shaderI->BindUniformBlock("WindowBlock", WindowBlockBinding);
+			TextureAtlas::BindBlock(*m_shaderI);
+
+			// Never matches a real block, the first Draw uploads
+			m_uploaded[WindowDraw].WinLimit[0] = std::nanf("");
+		}
+
+		/**
+		 * @brief Uploads the blocks of the next draws, only when the window moved, resized or scrolled its slider.
+		 */
+		void UpdateBlocks(const Window& window)
+		{
+			DrawBlock blocks[DrawBlocks];
+
+			blocks[WindowDraw].M = window.ModelMatrix();
+			blocks[RowsDraw].M = window.IconMatrix();
+			blocks[SliderDraw].M = window.SliderMatrix();
+
+			// The icons are clipped against gl_FragCoord, the rows to their box and the thumb to the track
+			ClipLimits(window.m_bounds, window.m_ContextHeight, blocks[WindowDraw].WinLimit);
+			ClipLimits(window.m_rows->Rect(), window.m_ContextHeight, blocks[RowsDraw].WinLimit);
+			ClipLimits(window.m_slider->Rect(), window.m_ContextHeight, blocks[SliderDraw].WinLimit);
+
+			if (std::memcmp(blocks, m_uploaded, sizeof(blocks)) == 0)
+				return;
+
+			for (unsigned int i = 0; i < DrawBlocks; i++)
+				std::memcpy(m_BlockData.data() + i * m_BlockStride, &blocks[i], sizeof(DrawBlock));
+
+			m_blocks.Update(m_BlockData.data(), static_cast<unsigned int>(m_BlockData.size()));
+			std::memcpy(m_uploaded, blocks, sizeof(blocks));
+		}
+
+		/**
+		 * @brief Makes WindowBlock read the block of one draw.
+		 */
+		void BindBlock(DrawBlockIndex index) const
+		{
+			m_blocks.BindRange(WindowBlockBinding, index * m_BlockStride, sizeof(DrawBlock));
+		}
+	};
 
 
 	//---------------------------------------- PUBLIC
@@ -30,45 +245,41 @@ namespace Vicetrice
 	*
 	* @param ContextWidth Width of the context (window).
 	* @param ContextHeight Height of the context (window).
-	* @param shPath Path to the shader files.
+	* @param standalone False for a window drawn by a WindowManager, no GL object is created for it.
 	*/
-	Window::Window(int ContextWidth, int ContextHeight)
-		: m_model{ 1.0f },
+	Window::Window(int ContextWidth, int ContextHeight, bool standalone)
+		: m_bounds{ ContextWidth * 0.25f, ContextHeight * 0.25f, ContextWidth * 0.75f, ContextHeight * 0.75f },
+		m_proj{ glm::ortho(0.0f, static_cast<float>(ContextWidth), static_cast<float>(ContextHeight), 0.0f, -1.0f, 1.0f) },
+		m_tree{ ContextWidth, ContextHeight, !standalone },
+		m_rows{ nullptr },
+		m_slider{ nullptr },
 		m_dragging{ false },
-		m_render{ true },
+		m_damage{},
 		m_ContextWidth{ ContextWidth },
 		m_ContextHeight{ ContextHeight },
 		m_lastMouseX{ 0.0 },
 		m_lastMouseY{ 0.0 },
 		m_resize{ ResizeTypes::NORESIZE },
 		m_moving{ false },
-		m_IndexToFirstIconToRender{ 0 },
-		m_MaxIconsToRender{ 40 },
-		m_va{},
-		m_vb{ IniVertex(), (static_cast <unsigned int> (sizeof(float) * m_vertex.size())) + (VerticesPerIcon * m_MaxIconsToRender * sizeof(float))},
-		m_shader{ "res/shaders/Window.shader" },
-		m_ib{ IniIndex(),(static_cast<unsigned int> (sizeof(unsigned int) * m_indices.size())) + (IndicesPerIcon * m_MaxIconsToRender * sizeof(unsigned int)) },
-		m_vaI{},
-		m_vbI{ nullptr,VerticesPerIcon * m_MaxIconsToRender * sizeof(float)},
-		m_shaderI{ "res/shaders/Icon.shader" },
-		m_ibI{ nullptr,IndicesPerIcon * m_MaxIconsToRender * sizeof(unsigned int) },
-		m_SliderEnable{ false },
-		m_SliderModel{ 1.0f }, //TODO: ADD IT TO CLASS SLIDERICON,
-		m_sliding{ false }
+		m_resources{},
+		m_StreamInstance{ 0 },
+		m_StreamRevision{ ~0ull },
+		m_atlas{ nullptr }
 	{
+		IniVertex();
+		IniIndex();
 
-		VertexBufferLayout layout;
-
-		layout.Push<float>(2);
-		layout.Push<float>(4);
-		layout.Push<float>(1);
-
-		m_va.addBuffer(m_vb, layout);
-
-		m_vaI.addBuffer(m_vbI, layout);
+		BuildWidgets();
+		RenderIcon();
 
-		updateLimits();
+		if (standalone)
+		{
+			m_resources = std::make_unique<Resources>(*this);
+			StreamInstances();
+		}
 
+		m_damage.SetBounds(ContextWidth, ContextHeight);
+		m_damage.AddAll();
 	}
 
 
@@ -79,7 +290,7 @@ namespace Vicetrice
 	}
 
 	/**
-		 * @brief Adjusts the projection matrix based on the new context dimensions.
+		 * @brief Adjusts the projection matrix based on the new context dimensions, the window keeps its size in pixels.
 		 *
 		 * @param ContextWidth New width of the context.
 		 * @param ContextHeight New height of the context.
@@ -88,7 +299,13 @@ namespace Vicetrice
 
 		m_ContextWidth = ContextWidth;
 		m_ContextHeight = ContextHeight;
-		m_render = true;
+		m_proj = glm::ortho(0.0f, static_cast<float>(ContextWidth), static_cast<float>(ContextHeight), 0.0f, -1.0f, 1.0f);
+
+		// WriteBatch places the rectangles of the widgets in NDC of the new context
+		m_tree.SetContextSize(ContextWidth, ContextHeight);
+
+		m_damage.SetBounds(ContextWidth, ContextHeight);
+		m_damage.AddAll();
 	}
 
 	/**
@@ -99,25 +316,37 @@ namespace Vicetrice
 	  * @param action Action taken (e.g., press, release).
 	  */
 	void Window::DragON(GLFWwindow* context, int button, int action)
+	{
+		double mouseX, mouseY;
+		glfwGetCursorPos(context, &mouseX, &mouseY);
+
+		DragON(context, button, action, mouseX, mouseY);
+	}
+
+	/**
+	  * @brief Enables or disables dragging of the window at a given mouse position.
+	  *
+	  * @param context Pointer to the GLFW window context, may be null when running headless.
+	  * @param button Mouse button involved in the action.
+	  * @param action Action taken (e.g., press, release).
+	  * @param mouseX X position of the mouse.
+	  * @param mouseY Y position of the mouse.
+	  */
+	void Window::DragON(GLFWwindow* context, int button, int action, double mouseX, double mouseY)
 	{
 		if (button == GLFW_MOUSE_BUTTON_LEFT)
 		{
-			double mouseX, mouseY;
-			glfwGetCursorPos(context, &mouseX, &mouseY);
-
-			float normalizedMouseX, normalizedMouseY;
-			NormalizeMouseCoords(mouseX, mouseY, normalizedMouseX, normalizedMouseY);
+			float x = static_cast<float>(mouseX);
+			float y = static_cast<float>(mouseY);
 			if (action == GLFW_PRESS)
 			{
-				if (IsMouseInsideObject(normalizedMouseX, normalizedMouseY))
+				if (IsMouseInsideObject(x, y))
 				{
 					m_dragging = true;
-					m_lastMouseX = normalizedMouseX;
-					m_lastMouseY = normalizedMouseY;
-					CheckResize(context, normalizedMouseX, normalizedMouseY);
-					if (CheckSlide(normalizedMouseX, normalizedMouseY))
-						m_sliding = true;
-					else if (m_resize == ResizeTypes::NORESIZE)
+					m_lastMouseX = mouseX;
+					m_lastMouseY = mouseY;
+					CheckResize(context, x, y);
+					if (!m_slider->Press(x, y) && m_resize == ResizeTypes::NORESIZE)
 						m_moving = true;
 
 				}
@@ -125,8 +354,16 @@ namespace Vicetrice
 			else if (action == GLFW_RELEASE) {
 				m_dragging = false;
 				m_moving = false;
-				m_sliding = false;
-				CheckResize(context, normalizedMouseX, normalizedMouseY);
+				CheckResize(context, x, y);
+
+				// The thumb leaves the pointer and snaps to the first visible row
+				if (m_slider->Dragging())
+				{
+					DamageSlider();
+					m_slider->Release();
+					UpdateLayout();
+					DamageSlider();
+				}
 			}
 		}
 	}
@@ -140,48 +377,40 @@ namespace Vicetrice
 		*/
 	void Window::Move(double xpos, double ypos)
 	{
+		VICE_PROFILE_ZONE("Window::Move");
+
 		if (m_dragging && m_resize == ResizeTypes::NORESIZE)
 		{
-			float normalizedMouseX, normalizedMouseY;
-			NormalizeMouseCoords(xpos, ypos, normalizedMouseX, normalizedMouseY);
-			float deltaXNorm = static_cast<float>(normalizedMouseX - m_lastMouseX);
-			float deltaYNorm = static_cast<float>(normalizedMouseY - m_lastMouseY);
+			float deltaX = static_cast<float>(xpos - m_lastMouseX);
+			float deltaY = static_cast<float>(ypos - m_lastMouseY);
 			if (m_moving)
 			{
-				m_model = glm::translate(m_model, glm::vec3(deltaXNorm, deltaYNorm, 0.0f));
+				DamageWindow();
+				m_bounds.left += deltaX;
+				m_bounds.right += deltaX;
+				m_bounds.top += deltaY;
+				m_bounds.bottom += deltaY;
+
+				// Same size, the layout only moves
+				UpdateLayout();
 			}
-			if (m_SliderEnable && m_sliding)
+			if (m_slider->Dragging())
 			{
-				m_SliderModel = glm::translate(m_SliderModel, glm::vec3(0.0f, deltaYNorm, 0.0f));
-				if (m_SliderModel[3].y > 0.0f)
-				{
-					m_SliderModel[3][0] = 0.0f;
-					m_SliderModel[3][1] = 0.0f;
-					m_SliderModel[3][2] = 0.0f;
-				}
-				else if (m_SlideLimits[3] + m_SliderModel[3].y < m_WindowLimits[3])
-				{
-					m_SliderModel[3][0] = 0.0f;
-					m_SliderModel[3][1] = m_WindowLimits[3] - m_SlideLimits[3];
-					m_SliderModel[3][2] = 0.0f;
-				}
+				DamageSlider();
 
+				// The slider decides the first row to render from the displacement
+				if (m_slider->Drag(deltaY))
+					DamageRows(0);
 
-				//Calculate the displacement based on the number of icons
-				float displacementPerIcon = (m_icons.size() - (m_MaxIconsToRender - 2)) != 0 ? (m_WindowLimits[3] - m_SlideLimits[3]) / (m_icons.size() - (m_MaxIconsToRender - 2)) : (m_WindowLimits[3] - m_SlideLimits[3]);
-				//Calculate the index of the first icon to render based on the displacement
-				unsigned int index = static_cast<unsigned int>(m_SliderModel[3].y / displacementPerIcon);
-				m_IndexToFirstIconToRender = index;
-
-				//std::cout << "MITR: " << m_MaxIconsToRender << std::endl;
-				//std::cout << "MICONS: " << m_icons.size() << std::endl;
-				//std::cout << "MD: " << index << std::endl;
 				RenderIcon();
+				DamageSlider();
 			}
-			updateLimits();
 
-			m_lastMouseX = normalizedMouseX;
-			m_lastMouseY = normalizedMouseY;
+			if (m_moving)
+				DamageWindow();
+
+			m_lastMouseX = xpos;
+			m_lastMouseY = ypos;
 		}
 	}
 
@@ -191,55 +420,22 @@ namespace Vicetrice
 		 */
 	void Window::Draw()
 	{
-		/*bool first = true;
+		VICE_PROFILE_ZONE("Window::Draw");
 
-		for (size_t i = 0; i < m_vertex.size(); i++)
-		{
-			if (first)
-			{
-				std::cout << "VERTEX ARRAY\n" << "{";
-				first = false;
-			}
-			else
-			{
-				std::cout << ", ";
-			}
-			if (i % 7 == 0 && i != 0)
-			{
-				std::cout << std::endl;
-			}
-			std::cout << m_vertex[i];
-		}
-		std::cout << "}" << std::endl;
-		first = true;
-		for (size_t i = 0; i < m_indices.size(); i++)
-		{
-			if (first)
-			{
-				std::cout << "INDEX ARRAY\n" << "{";
-				first = false;
-			}
-			else
-			{
-				std::cout << ", ";
-			}
-			if (i % 3 == 0 && i != 0)
-			{
-				std::cout << std::endl;
-			}
-			std::cout << m_indices[i];
-		}
-		std::cout << "}" << std::endl;*/
+		if (!m_resources)
+			return;
+
+		m_resources->UpdateBlocks(*this);
 
-		m_shader.Bind();
-		m_shader.SetUniformMat4f("u_M", m_model);
+		m_resources->m_shader->Bind();
+		m_resources->BindBlock(WindowDraw);
 
 
-		m_va.Bind();
-		m_ib.Bind();
-		GLCall(glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(m_indices.size()), GL_UNSIGNED_INT, nullptr));
+		m_resources->m_va.Bind();
+		m_resources->m_ib.Bind();
+		Backend::Get().DrawElements(GL_TRIANGLES, static_cast<int>(m_indices.size()), GL_UNSIGNED_INT, 0);
+		VICE_PROFILE_COUNT(DrawCalls, 1);
 		DrawIcon();
-		m_render = false;
 	}
 
 	/**
@@ -249,89 +445,128 @@ namespace Vicetrice
 	  * @param xpos X position of the mouse.
 	  * @param ypos Y position of the mouse.
 	  *
-	  * TODO: ADD RESIZING LIMITS
+	  * The window does not shrink below MinWidth x MinHeight, the dragged edges stop there.
 	  */
 	void Window::Resize(GLFWwindow* context, double xpos, double ypos)
 	{
-		float normalizedMouseX = 0.0f;
-		float normalizedMouseY = 0.0f;
+		VICE_PROFILE_ZONE("Window::Resize");
 
 		if (!m_moving)
-		{
-			NormalizeMouseCoords(xpos, ypos, normalizedMouseX, normalizedMouseY);
-			CheckResize(context, normalizedMouseX, normalizedMouseY);
-		}
+			CheckResize(context, static_cast<float>(xpos), static_cast<float>(ypos));
 
 		if (m_dragging && m_resize != ResizeTypes::NORESIZE && !m_moving)
 		{
+			DamageWindow();
+
+			float deltaX = static_cast<float>(xpos - m_lastMouseX);
+			float deltaY = static_cast<float>(ypos - m_lastMouseY);
+
+			bool left = m_resize == ResizeTypes::LXRESIZE || m_resize == ResizeTypes::LXDYRESIZE || m_resize == ResizeTypes::LXUYRESIZE;
+			bool right = m_resize == ResizeTypes::RXRESIZE || m_resize == ResizeTypes::RXDYRESIZE || m_resize == ResizeTypes::RXUYRESIZE;
+			bool top = m_resize == ResizeTypes::UYRESIZE || m_resize == ResizeTypes::RXUYRESIZE || m_resize == ResizeTypes::LXUYRESIZE;
+			bool bottom = m_resize == ResizeTypes::DYRESIZE || m_resize == ResizeTypes::RXDYRESIZE || m_resize == ResizeTypes::LXDYRESIZE;
+
+			if (left)
+				m_bounds.left = std::min(m_bounds.left + deltaX, m_bounds.right - MinWidth);
+			if (right)
+				m_bounds.right = std::max(m_bounds.right + deltaX, m_bounds.left + MinWidth);
+			if (top)
+				m_bounds.top = std::min(m_bounds.top + deltaY, m_bounds.bottom - MinHeight);
+			if (bottom)
+				m_bounds.bottom = std::max(m_bounds.bottom + deltaY, m_bounds.top + MinHeight);
+
+			// Lays the window out again, keeps the slider on the first visible row
+			RenderIcon();
+			DamageWindow();
+			m_lastMouseX = xpos;
+			m_lastMouseY = ypos;
+		}
+	}
 
-			float deltaXNorm = static_cast<float>(normalizedMouseX - m_lastMouseX);
-			float deltaYNorm = static_cast<float>(normalizedMouseY - m_lastMouseY);
+	/**
+	 * @brief Rectangles WriteBatch writes: the panel, the visible rows and the slider.
+	 */
+	unsigned int Window::BatchInstances() const
+	{
+		return m_tree.BatchInstances();
+	}
 
-			switch (m_resize)
-			{
-			case Vicetrice::ResizeTypes::RXRESIZE:
-				m_vertex[7] = m_vertex[14] += deltaXNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::LXRESIZE:
-				m_vertex[21] = m_vertex[0] += deltaXNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::UYRESIZE:
-				m_vertex[15] = m_vertex[22] += deltaYNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::DYRESIZE:
-				m_vertex[1] = m_vertex[8] += deltaYNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::RXDYRESIZE:
-				m_vertex[7] = m_vertex[14] += deltaXNorm;
-				m_vertex[1] = m_vertex[8] += deltaYNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::RXUYRESIZE:
-				m_vertex[7] = m_vertex[14] += deltaXNorm;
-				m_vertex[15] = m_vertex[22] += deltaYNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::LXDYRESIZE:
-				m_vertex[21] = m_vertex[0] += deltaXNorm;
-				m_vertex[1] = m_vertex[8] += deltaYNorm;
-				break;
-
-			case Vicetrice::ResizeTypes::LXUYRESIZE:
-				m_vertex[21] = m_vertex[0] += deltaXNorm;
-				m_vertex[15] = m_vertex[22] += deltaYNorm;
-				break;
-
-			default:
-				break;
-			}
+	/**
+	 * @brief Writes the window as rectangles of the batch shader, back to front, copied from the widgets.
+	 *
+	 * Rows are clipped to their box and the slider to its track, the panel to nothing.
+	 *
+	 * @param out Room for BatchInstances() * BatchFloats floats.
+	 * @return One past the last float written.
+	 */
+	float* Window::WriteBatch(float* out) const
+	{
+		return m_tree.WriteBatch(out);
+	}
 
-			updateLimits();
-			if (m_IndexToFirstIconToRender != 0 && (m_MaxIconsToRender + m_IndexToFirstIconToRender - 2) > m_icons.size())
-			{
-				--m_IndexToFirstIconToRender;
-			}
+	/**
+	 * @brief Checks if a mouse position falls on the window.
+	 *
+	 * @param mouseX X position of the mouse.
+	 * @param mouseY Y position of the mouse.
+	 */
+	bool Window::Contains(double mouseX, double mouseY) const
+	{
+		return IsMouseInsideObject(static_cast<float>(mouseX), static_cast<float>(mouseY));
+	}
+
+	/**
+	 * @brief Rectangle where Contains is true, in mouse coordinates (y grows downwards).
+	 */
+	void Window::Bounds(double& left, double& top, double& right, double& bottom) const
+	{
+		left = m_bounds.left - BorderGrab;
+		right = m_bounds.right + BorderGrab;
+		top = m_bounds.top - BorderGrab;
+		bottom = m_bounds.bottom + BorderGrab;
+	}
 
-			float displacementPerIcon = (m_icons.size() - (m_MaxIconsToRender - 2)) != 0 ? (m_WindowLimits[3] - m_SlideLimits[3]) / (m_icons.size() - (m_MaxIconsToRender - 2)) : (m_WindowLimits[3] - m_SlideLimits[3]);
-			//Calculate Slider position based on index
-			float displacement = displacementPerIcon * m_IndexToFirstIconToRender;
-			m_SliderModel[3].y = displacement;
+	/**
+	 * @brief Index in the source of the visible row under a mouse position, NoIcon if there is none.
+	 */
+	unsigned int Window::IconAt(double mouseX, double mouseY) const
+	{
+		unsigned int row = m_rows->RowAt(static_cast<float>(mouseX), static_cast<float>(mouseY));
 
-			m_vb.Update(m_vertex.data(), static_cast<unsigned int>(m_vertex.size() * sizeof(float)));
-			RenderIcon();
-			m_lastMouseX = normalizedMouseX;
-			m_lastMouseY = normalizedMouseY;
-		}
+		return row != ListView::NoRow ? row : NoIcon;
+	}
+
+	/**
+	 * @brief Places the top left corner of the window, in pixels of the context.
+	 */
+	void Window::SetPosition(float left, float top)
+	{
+		DamageWindow();
+
+		m_bounds.right += left - m_bounds.left;
+		m_bounds.bottom += top - m_bounds.top;
+		m_bounds.left = left;
+		m_bounds.top = top;
+		UpdateLayout();
+
+		DamageWindow();
+	}
+
+	/**
+	 * @brief Damages the bounds of the window, e.g. when it is raised over others.
+	 */
+	void Window::Invalidate()
+	{
+		DamageWindow();
 	}
 
 	/**
 	 * @brief Adds an icon to the window.
+	 *
+	 * @param image Image of the icon in the atlas of the window, see SetAtlas.
+	 * @param label Text of the row, UTF-8, see SetFont.
 	 */
-	void Window::addIcon()
+	void Window::addIcon(unsigned int image, const std::string& label)
 	{
 
 		std::random_device rd;  // Fuente de entropía
@@ -342,9 +577,72 @@ namespace Vicetrice
 
 		// Generar un número aleatorio
 		float randomValue = static_cast<float>(dis(gen));
-		m_icons.emplace_back(Icon(glm::vec4(1.0f, randomValue, 0.0f, 1.0f)));
+		m_list.Add(glm::vec4(1.0f, randomValue, 0.0f, 1.0f), 0, image, label);
+
+		if (m_rows->Source() == &m_list)
+			SourceChanged(m_list.Count() - 1);
+	}
+
+	/**
+	 * @brief Sets the atlas the images of the icons are in, a standalone window binds it to draw them.
+	 *
+	 * @param atlas Not owned, nullptr draws every icon flat.
+	 */
+	void Window::SetAtlas(const TextureAtlas* atlas)
+	{
+		m_atlas = atlas;
+		DamageWindow();
+	}
+
+	/**
+	 * @brief Sets the font of the labels of the rows, they are drawn when a WindowManager draws the window.
+	 *
+	 * @param font Not owned, nullptr draws no label.
+	 */
+	void Window::SetFont(Font* font)
+	{
+		m_rows->SetFont(font, LabelColor);
+		UpdateLayout();
+		DamageRows(0);
+	}
+
+	/**
+	 * @brief Shows the rows of another source, only the visible rows are fetched from it.
+	 *
+	 * @param source Source of the rows, nullptr goes back to the icons added with addIcon.
+	 */
+	void Window::SetSource(IconSource* source)
+	{
+		DamageSlider();
+
+		//RESET POSITION
+		m_rows->SetSource(source != nullptr ? source : &m_list);
+		m_slider->SetPosition(0);
+		SourceChanged();
+	}
+
+	/**
+	 * @brief Notifies the window that rows of its source changed or were added/removed.
+	 *
+	 * @param FirstChangedRow Rows from this one on are fetched again when visible.
+	 */
+	void Window::SourceChanged(unsigned int FirstChangedRow)
+	{
+		unsigned int first = m_rows->First();
+		bool slider = m_slider->Visible();
+
+		DamageSlider();
+
+		m_rows->RowsChanged(FirstChangedRow);
 		RenderIcon();
-		m_render = true;
+
+		// Showing or hiding the slider changes the width of every row
+		if (m_slider->Visible() != slider)
+			DamageWindow();
+		else
+			DamageRows(m_rows->First() != first ? 0 : FirstChangedRow);
+
+		DamageSlider();
 	}
 
 	//---------------------------------------- PRIVATE
@@ -359,10 +657,10 @@ namespace Vicetrice
 
 		m_vertex = {
 			//Position		//Color					//VertexID
-			-0.5f, -0.5f,	0.8f,0.2f,0.9f,1.0f,	0.0f,	// 0-LD
-			 0.5f, -0.5f,	0.8f,0.2f,0.9f,1.0f,	1.0f,	// 1-RD
-			 0.5f,  0.5f,	0.8f,0.2f,0.9f,1.0f,	2.0f,	// 2-RU
-			-0.5f,  0.5f,	0.8f,0.2f,0.9f,1.0f,	3.0f	// 3-LU
+			0.0f, 1.0f,		0.8f,0.2f,0.9f,1.0f,	0.0f,	// 0-LD
+			1.0f, 1.0f,		0.8f,0.2f,0.9f,1.0f,	1.0f,	// 1-RD
+			1.0f, 0.0f,		0.8f,0.2f,0.9f,1.0f,	2.0f,	// 2-RU
+			0.0f, 0.0f,		0.8f,0.2f,0.9f,1.0f,	3.0f	// 3-LU
 		};
 
 		return m_vertex.data();
@@ -388,314 +686,332 @@ namespace Vicetrice
 	}
 
 	/**
-		* @brief Renders an icon on the window.
+		* @brief Creates the widgets of the window.
+		*
+		* The panel holds the header on top of the body, which holds the rows left of the slider.
 		*/
-	void Window::RenderIcon()
+	void Window::BuildWidgets()
 	{
+		Panel& panel = m_tree.Root();
+		panel.SetColor(glm::vec4(m_vertex[2], m_vertex[3], m_vertex[4], m_vertex[5]));
 
-		auto start = std::chrono::high_resolution_clock::now();
+		LayoutStyle header;
+		header.size = LayoutSize::Pixels(HeaderHeight);
+		panel.Add<Panel>(header);
 
-		if (m_icons.empty())
-		{
-			return;
-		}
-
-		m_MaxIconsToRender = static_cast<unsigned int>(((m_WindowLimits[2] - m_WindowLimits[3]) / 0.1) + 1);
-		if (m_MaxIconsToRender == 0)
-			m_MaxIconsToRender = 2;
+		LayoutStyle body;
+		body.direction = LayoutDirection::Horizontal;
+		Panel& BodyPanel = panel.Add<Panel>(body);
 
+		LayoutStyle rows;
+		m_rows = &BodyPanel.Add<ListView>(rows, &m_list, RowHeight);
 
-		//CAN BE ELIMINATED IF RESIZING LIMITS GOT DEFINED
-		if (m_MaxIconsToRender > 30)
-			m_MaxIconsToRender = 30;
+		// Takes no room until the rows do not fit
+		LayoutStyle track;
+		track.padding.left = ThumbInset;
+		track.padding.right = ThumbInset;
+		m_slider = &BodyPanel.Add<ScrollBar>(track, SliderWidth, MinThumbHeight);
+	}
 
-		unsigned int limit;
-		float SizeForSlider = 0.0f;
-		m_SliderEnable = false;
+	/**
+		* @brief Renders an icon on the window.
+		*
+		* Only the visible rows missing from the slot ring are fetched from the source and uploaded,
+		* scrolling and resizing are handled by uniforms and the icon and slider matrices.
+		*/
+	void Window::RenderIcon()
+	{
+		VICE_PROFILE_ZONE("Window::RenderIcon");
 
-		if (m_icons.size() > m_MaxIconsToRender - 2)
-		{
-			SizeForSlider = 0.05f;
-			m_SliderEnable = true;
-			updateLimits();
-		}
-		else
-		{
-			//RESET POSITION
-			m_SliderModel[3][0] = 0.0f;
-			m_SliderModel[3][1] = 0.0f;
-			m_SliderModel[3][2] = 0.0f;
+		// The slider only changes the width of the rows, so their height is known before deciding on it
+		UpdateLayout();
+		m_rows->Fit();
 
-			m_IndexToFirstIconToRender = 0;
-		}
+		// Rows removed or a taller window may leave fewer rows to scroll, the slider clamps its position
+		m_slider->SetRange(m_rows->RowCount(), m_rows->FullRows());
+		UpdateLayout();
 
+		m_rows->ScrollTo(m_slider->Position());
+		UpdateLayout();
 
-		std::vector<float> IconsToRender;
-		std::vector<unsigned int>IconsIndicesToRender;
+		StreamInstances();
+	}
 
-		IconsToRender.reserve(VerticesPerIcon * m_MaxIconsToRender);
-		IconsIndicesToRender.reserve(IndicesPerIcon * m_MaxIconsToRender);
 
-		unsigned int IconCount = 1;
+	/**
+	* @brief Removes an icon from the window.
+	*
+	* The slot of the removed icon is invalidated, a row added later at the same index is fetched again.
+	*/
+	void Window::RemoveIcon()
+	{
+		m_list.RemoveLast();
 
+		if (m_rows->Source() != &m_list)
+			return;
 
-		IconsToRender = {
+		SourceChanged(m_list.Count());
+	}
 
-			//Position											//Color					//VertexID
-			m_vertex[21]				, m_vertex[22] - 0.1f ,	0.0f,1.0f,1.0f,1.0f,	0.0f,
-			m_vertex[14] - SizeForSlider, m_vertex[15] - 0.1f ,	0.0f,1.0f,1.0f,1.0f,	1.0f
-		};
 
+	/**
+	 * @brief Draws an icon on the window.
+	 */
+	void Window::DrawIcon()
+	{
 
-		limit = m_icons.size() > (m_MaxIconsToRender + m_IndexToFirstIconToRender) ? m_MaxIconsToRender + m_IndexToFirstIconToRender : m_icons.size();
+		m_resources->m_shaderI->Bind();
 
+		m_resources->m_vaI.Bind();
+		m_resources->m_ibI.Bind();
 
-		for (unsigned int i = m_IndexToFirstIconToRender; i < limit; i++)
-		{
-			m_icons[i].AddToContext(IconsToRender, IconsIndicesToRender, 1, IconCount);
-			++IconCount;
-		}
+		m_resources->BindBlock(RowsDraw);
+		m_resources->m_shaderI->SetUniform1f(m_resources->m_FirstRow, static_cast<float>(m_rows->First()));
+		m_resources->m_shaderI->SetUniform1f(m_resources->m_RowAspect, m_rows->Rect().Width() / RowHeight);
 
-		if (m_SliderEnable)
-		{
-			//TODO: Crear Vertices del slider a partir de m_SliderLimits
-			//IMPORTANT: DANGEROUS CALCULATIONS AHEAD CHANGE IN CASE OF BUGS
-			float WindowH = static_cast<float>(m_MaxIconsToRender) > 4.0f ? static_cast<float>(m_MaxIconsToRender) - 4.0f : 0.0f;
-			float size = m_icons.empty() ? 1.0f : static_cast<float>(m_icons.size());
-			float Aux = 0.13f + (WindowH / size);
-			float VariableSize = (Aux > 1.0f || Aux < -1.0f) ? 0.13f : Aux;
-			//END OF IMPORTANT
-
-			float aux[] =
-			{
-				//Position																	 //Color				//VertexID
-				m_vertex[14] - 0.04f , m_vertex[15] - VariableSize + m_SliderModel[3].y	,	 1.0f,1.0f,1.0f,1.0f,	IconsToRender.back() + 1.0f, //LD
-				m_vertex[14] - 0.01f , m_vertex[15] - VariableSize + m_SliderModel[3].y	,	 1.0f,1.0f,1.0f,1.0f,	IconsToRender.back() + 2.0f, //RD 
-				m_vertex[14] - 0.01f , m_vertex[15] - 0.1f + m_SliderModel[3].y			,	 1.0f,1.0f,1.0f,1.0f,	IconsToRender.back() + 3.0f, //RU 
-				m_vertex[14] - 0.04f , m_vertex[15] - 0.1f + m_SliderModel[3].y			,	 1.0f,1.0f,1.0f,1.0f,	IconsToRender.back() + 4.0f, //LU
-			};
-
-			float auxIndex[] =
-			{
-				aux[27], aux[6], aux[13],
-				aux[27], aux[20], aux[13]
+		// One texture for the images of every row
+		if (m_atlas != nullptr)
+			m_atlas->Bind();
 
-			};
+		// The slider and then the visible rows in order, as StreamInstances wrote them
+		DrawInstances(m_StreamInstance + FirstRowInstance, m_rows->Shown());
 
-			for (unsigned int i = 0; i < sizeof(aux) / sizeof(float); i++)
-			{
-				IconsToRender.emplace_back(aux[i]);
-			}
-			for (unsigned int i = 0; i < sizeof(auxIndex) / sizeof(float); i++)
-			{
-				IconsIndicesToRender.emplace_back(static_cast<unsigned int>(auxIndex[i]));
-			}
+		if (m_slider->Visible())
+		{
+			m_resources->BindBlock(SliderDraw);
+			m_resources->m_shaderI->SetUniform1f(m_resources->m_FirstRow, 0.0f);
+			DrawInstances(m_StreamInstance, 1);
 		}
 
+	}
 
-		m_vbI.Update(IconsToRender.data(), static_cast<unsigned int>(IconsToRender.size() * sizeof(float)));
-		m_ibI.Update(IconsIndicesToRender.data(), static_cast<unsigned int>(IconsIndicesToRender.size() * sizeof(unsigned int)));
 
-		auto end = std::chrono::high_resolution_clock::now();
-		std::chrono::duration<double, std::milli> elapsed = end - start;
+	/**
+	 * @brief Damages a rectangle of the context, padded to whole pixels.
+	 *
+	 * The damage is kept in framebuffer pixels, y grows upwards.
+	 */
+	void Window::DamageRect(const LayoutRect& rect)
+	{
+		int x0 = static_cast<int>(std::floor(rect.left)) - DamagePadding;
+		int y0 = static_cast<int>(std::floor(m_ContextHeight - rect.bottom)) - DamagePadding;
+		int x1 = static_cast<int>(std::ceil(rect.right)) + DamagePadding;
+		int y1 = static_cast<int>(std::ceil(m_ContextHeight - rect.top)) + DamagePadding;
 
-		std::cout << "Elapsed time: " << elapsed.count() << " milliseconds" << std::endl;
+		m_damage.Add(x0, y0, x1 - x0, y1 - y0);
+	}
 
-		/*bool first = true;
 
-		for (size_t i = 0; i < IconsToRender.size(); i++)
-		{
-			if (first)
-			{
-				std::cout << "VERTEX ARRAY\n" << "{";
-				first = false;
-			}
-			else
-			{
-				std::cout << ", ";
-			}
-			if (i % 7 == 0 && i != 0)
-			{
-				std::cout << std::endl;
-			}
-			std::cout << IconsToRender[i];
-		}
-		std::cout << "}" << std::endl;
-		first = true;
-		for (size_t i = 0; i < IconsIndicesToRender.size(); i++)
-		{
-			if (first)
-			{
-				std::cout << "INDEX ARRAY\n" << "{";
-				first = false;
-			}
-			else
-			{
-				std::cout << ", ";
-			}
-			if (i % 3 == 0 && i != 0)
-			{
-				std::cout << std::endl;
-			}
-			std::cout << IconsIndicesToRender[i];
-		}
-		std::cout << "}" << std::endl;*/
+	/**
+	 * @brief Damages the current bounds of the window.
+	 */
+	void Window::DamageWindow()
+	{
+		DamageRect(m_bounds);
+	}
+
 
+	/**
+	 * @brief Damages the current slider thumb, if the slider is shown.
+	 */
+	void Window::DamageSlider()
+	{
+		if (!m_slider->Visible())
+			return;
 
+		DamageRect(m_slider->ThumbRect());
 	}
 
 
 	/**
-	* @brief Removes an icon from the window.
-	*/
-	void Window::RemoveIcon()
+	 * @brief Damages the rows from the given one down to the bottom of the window.
+	 *
+	 * The rows are clipped to their box by the icon shader, so is the damage.
+	 *
+	 * @param row Row of the source, rows above the first visible one damage from the top.
+	 */
+	void Window::DamageRows(unsigned int row)
 	{
-		if (!m_icons.empty())
-			m_icons.pop_back();
-		if (m_IndexToFirstIconToRender != 0 && (m_MaxIconsToRender + m_IndexToFirstIconToRender - 2) > m_icons.size())
-		{
-			--m_IndexToFirstIconToRender;
-		}
-		RenderIcon();
-		m_render = true;
+		unsigned int first = row > m_rows->First() ? row - m_rows->First() : 0;
+
+		LayoutRect damaged = m_rows->Rect();
+		damaged.top += RowHeight * static_cast<float>(first);
+		if (damaged.top >= damaged.bottom)
+			return;
+
+		DamageRect(damaged);
 	}
 
 
 	/**
-	 * @brief Draws an icon on the window.
+	 * @brief Writes the slider and the visible rows, in order, to the next range of the stream buffer if they changed.
+	 *
+	 * The GPU may still be drawing from the ranges written before, so the whole visible set goes to a new range
+	 * every time, copied from the ring of m_rows straight into mapped memory. The rows then take a single draw call.
+	 * A window drawn by a WindowManager has no stream, WriteBatch copies the rows its ListView tessellated.
 	 */
-	void Window::DrawIcon()
+	void Window::StreamInstances()
 	{
+		if (!m_resources || m_StreamRevision == m_rows->Revision())
+			return;
+
+		unsigned int first = m_rows->First();
+		unsigned int count = m_rows->Shown();
+		unsigned int capacity = m_rows->Capacity();
 
-		m_shaderI.Bind();
-		m_shaderI.SetUniformMat4f("u_M", m_model);
+		const unsigned int stride = sizeof(IconInstance);
+		IconInstance* instances = static_cast<IconInstance*>(m_resources->m_InstanceStream.Map((FirstRowInstance + count) * stride, stride));
 
-		int viewportWidth = m_ContextWidth;
-		int viewportHeight = m_ContextHeight;
+		// The ring holds the visible rows in at most two runs
+		unsigned int FirstSlot = count != 0 ? first % capacity : 0;
+		unsigned int run = count < capacity - FirstSlot ? count : capacity - FirstSlot;
+		const IconInstance* ring = m_rows->Slots();
 
-		float xMaxNDC = m_WindowLimits[0];
-		float xMinNDC = m_WindowLimits[1];
-		float yMaxNDC = m_WindowLimits[2];
-		float yMinNDC = m_WindowLimits[3];
+		*instances++ = SliderInstance;
+		instances = std::copy_n(ring + FirstSlot, run, instances);
+		std::copy_n(ring, count - run, instances);
 
-		float xMaxScreen = ((xMaxNDC + 1.0f) / 2.0f) * viewportWidth;
-		float xMinScreen = ((xMinNDC + 1.0f) / 2.0f) * viewportWidth;
-		float yMaxScreen = ((yMaxNDC + 1.0f) / 2.0f) * viewportHeight;
-		float yMinScreen = ((yMinNDC + 1.0f) / 2.0f) * viewportHeight;
+		m_StreamInstance = m_resources->m_InstanceStream.Commit() / stride;
+		m_StreamRevision = m_rows->Revision();
+		VICE_PROFILE_COUNT(InstancesUploaded, FirstRowInstance + count);
+	}
 
-		m_shaderI.SetUniform4f("u_WinLimit", xMaxScreen, xMinScreen, yMaxScreen, yMinScreen);
 
-		m_vaI.Bind();
-		m_vbI.Bind();
-		m_ibI.Bind();
+	/**
+	 * @brief Returns the matrix the window quad is drawn with, the projection of its rectangle.
+	 */
+	glm::mat4 Window::ModelMatrix() const
+	{
+		glm::mat4 matrix = glm::translate(m_proj, glm::vec3(m_bounds.left, m_bounds.top, 0.0f));
+		return glm::scale(matrix, glm::vec3(m_bounds.Width(), m_bounds.Height(), 1.0f));
+	}
 
-		unsigned int size = static_cast<unsigned int>(m_icons.size());
 
-		unsigned int limit = (size - m_IndexToFirstIconToRender) > m_MaxIconsToRender ? m_MaxIconsToRender : size - m_IndexToFirstIconToRender;
+	/**
+	 * @brief Builds the matrix that maps icon space onto the rows box.
+	 *
+	 * Icon space has unit width and unit height rows going down from y = 0, the icon shader moves the first visible row (u_FirstRow)
+	 * to y = 0 so large row numbers never reach the matrix. Pixels grow downwards, so the rows are scaled by -RowHeight.
+	 *
+	 * @return The model matrix for the icon rows.
+	 */
+	glm::mat4 Window::IconMatrix() const
+	{
+		const LayoutRect& rows = m_rows->Rect();
 
+		glm::mat4 matrix = glm::translate(m_proj, glm::vec3(rows.left, rows.top, 0.0f));
+		return glm::scale(matrix, glm::vec3(rows.Width(), -RowHeight, 1.0f));
+	}
 
-		if (m_SliderEnable)
-		{
-			++limit;
-		}
 
-		GLCall(glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(limit * IndicesPerIcon), GL_UNSIGNED_INT, nullptr));
+	/**
+	 * @brief Builds the matrix that maps the unit slider quad onto the slider thumb.
+	 *
+	 * @return The model matrix for the slider.
+	 */
+	glm::mat4 Window::SliderMatrix() const
+	{
+		LayoutRect thumb = m_slider->ThumbRect();
 
+		glm::mat4 matrix = glm::translate(m_proj, glm::vec3(thumb.left, thumb.top, 0.0f));
+		return glm::scale(matrix, glm::vec3(thumb.Width(), thumb.Height(), 1.0f));
 	}
 
 
 	/**
-		 * @brief Updates the limits of the window based on its current position and size.
-		 */
-	void Window::updateLimits()
+	 * @brief Draws a run of consecutive instances of the icon VAO.
+	 *
+	 * @param FirstInstance First instance of the stream buffer to draw.
+	 * @param count Number of instances.
+	 */
+	void Window::DrawInstances(unsigned int FirstInstance, unsigned int count)
 	{
-		m_WindowLimits[0] = m_model[3].x + m_vertex[7];
-		m_WindowLimits[1] = m_model[3].x + m_vertex[0];
-		m_WindowLimits[2] = m_model[3].y + m_vertex[15];
-		m_WindowLimits[3] = m_model[3].y + m_vertex[1];
-
+		if (count == 0)
+			return;
 
-		//LIMITES DEL SLIDER
-		//IMPORTANT: DANGEROUS CALCULATIONS AHEAD CHANGE IN CASE OF BUGS
-		float WindowH = static_cast<float>(m_MaxIconsToRender) > 4.0f ? static_cast<float>(m_MaxIconsToRender) - 4.0f : 0.0f;
-		float size = m_icons.empty() ? 1.0f : static_cast<float>(m_icons.size());
-		float Aux = 0.13f + (WindowH / size);
-		float VariableSize = (Aux > 1.0f || Aux < -1.0f) ? 0.13f : Aux;
-		//END OF IMPORTANT
+		m_resources->m_vaI.SetFirstInstance(m_resources->m_InstanceStream.Buffer(), m_resources->m_InstanceLayout, m_resources->m_InstanceAttrib, FirstInstance);
+		Backend::Get().DrawElementsInstanced(GL_TRIANGLES, IndicesPerIcon, GL_UNSIGNED_INT, 0, static_cast<int>(count));
+		VICE_PROFILE_COUNT(DrawCalls, 1);
+	}
 
-		m_SlideLimits[0] = m_vertex[14] + m_model[3].x;
-		m_SlideLimits[1] = m_vertex[14] - 0.05f + m_model[3].x;
-		m_SlideLimits[2] = m_vertex[15] - 0.1f + m_model[3].y;
-		m_SlideLimits[3] = m_vertex[15] - VariableSize + m_model[3].y;
 
+	/**
+	 * @brief Lays out and tessellates the widgets that changed, nothing is done when none did.
+	 *
+	 * A window that only moved keeps its layout, the boxes move with it and only the tessellations are redone.
+	 */
+	void Window::UpdateLayout()
+	{
+		m_tree.SetBounds(m_bounds);
+		m_tree.Update();
 	}
 
 	/**
    * @brief Checks and adjusts the window resizing based on mouse position.
    *
    * @param context Pointer to the GLFW window context.
-   * @param normalizedMouseX Normalized X position of the mouse.
-   * @param normalizedMouseY Normalized Y position of the mouse.
+   * @param mouseX X position of the mouse in pixels.
+   * @param mouseY Y position of the mouse in pixels.
    */
-	void Window::CheckResize(GLFWwindow* context, float normalizedMouseX, float  normalizedMouseY)
+	void Window::CheckResize(GLFWwindow* context, float mouseX, float mouseY)
 	{
 
-		if (IsMouseInsideObject(normalizedMouseX, normalizedMouseY) && !m_dragging)
+		if (IsMouseInsideObject(mouseX, mouseY) && !m_dragging)
 		{
 
-			bool IsInRx = IsInBetween(epsilon, normalizedMouseX, m_WindowLimits[0]);
-			bool IsInLx = IsInBetween(epsilon, normalizedMouseX, m_WindowLimits[1]);
-			bool IsInUy = IsInBetween(epsilon, normalizedMouseY, m_WindowLimits[2]);
-			bool IsInDy = IsInBetween(epsilon, normalizedMouseY, m_WindowLimits[3]);
+			bool IsInRx = IsInBetween(BorderGrab, mouseX, m_bounds.right);
+			bool IsInLx = IsInBetween(BorderGrab, mouseX, m_bounds.left);
+			bool IsInUy = IsInBetween(BorderGrab, mouseY, m_bounds.top);
+			bool IsInDy = IsInBetween(BorderGrab, mouseY, m_bounds.bottom);
 
 
 
 			if (IsInLx && IsInUy)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_RESIZE_NWSE_CURSOR));
+				SetCursor(context, NWSEResizeCursor);
 				m_resize = ResizeTypes::LXUYRESIZE;
 				return;
 			}
 			else if (IsInLx && IsInDy)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_RESIZE_NESW_CURSOR));
+				SetCursor(context, NESWResizeCursor);
 				m_resize = ResizeTypes::LXDYRESIZE;
 				return;
 			}
 			else if (IsInRx && IsInUy)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_RESIZE_NESW_CURSOR));
+				SetCursor(context, NESWResizeCursor);
 				m_resize = ResizeTypes::RXUYRESIZE;
 				return;
 			}
 			else if (IsInRx && IsInDy)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_RESIZE_NWSE_CURSOR));
+				SetCursor(context, NWSEResizeCursor);
 				m_resize = ResizeTypes::RXDYRESIZE;
 				return;
 			}
 			else if (IsInLx)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_HRESIZE_CURSOR));
+				SetCursor(context, GLFW_HRESIZE_CURSOR);
 				m_resize = ResizeTypes::LXRESIZE;
 				return;
 
 			}
 			else if (IsInRx)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_HRESIZE_CURSOR));
+				SetCursor(context, GLFW_HRESIZE_CURSOR);
 				m_resize = ResizeTypes::RXRESIZE;
 				return;
 			}
 			else if (IsInDy)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_VRESIZE_CURSOR));
+				SetCursor(context, GLFW_VRESIZE_CURSOR);
 				m_resize = ResizeTypes::DYRESIZE;
 				return;
 			}
 			else if (IsInUy)
 			{
-				glfwSetCursor(context, glfwCreateStandardCursor(GLFW_VRESIZE_CURSOR));
+				SetCursor(context, GLFW_VRESIZE_CURSOR);
 				m_resize = ResizeTypes::UYRESIZE;
 				return;
 			}
@@ -703,7 +1019,7 @@ namespace Vicetrice
 
 		if (!m_dragging)
 		{
-			glfwSetCursor(context, NULL);
+			SetCursor(context, 0);
 			m_resize = ResizeTypes::NORESIZE;
 		}
 
@@ -712,48 +1028,30 @@ namespace Vicetrice
 
 
 	/**
-	* @brief Normalizes mouse coordinates from screen space to OpenGL space.
+	* @brief Sets one of the GLFW standard cursors on the context, through the CursorCache.
 	*
-	* @param mouseX X position of the mouse in screen space.
-	* @param mouseY Y position of the mouse in screen space.
-	* @param normalizedX Reference to store the normalized X position.
-	* @param normalizedY Reference to store the normalized Y position.
+	* @param context Pointer to the GLFW window context, nothing is done when it is null (headless runs).
+	* @param shape GLFW standard cursor shape, 0 restores the default cursor.
 	*/
-	void Window::NormalizeMouseCoords(double mouseX, double mouseY, float& normalizedX, float& normalizedY) const
+	void Window::SetCursor(GLFWwindow* context, int shape) const
 	{
-		normalizedX = (2.0f * (static_cast<float>(mouseX) / m_ContextWidth)) - 1.0f;
-		normalizedY = 1.0f - (2.0f * (static_cast<float>(mouseY) / m_ContextHeight));
+		CursorCache::Set(context, shape);
 	}
 
 
 	/**
-	* @brief Checks if the mouse is inside the window's object.
+	* @brief Checks if the mouse is inside the window's object, its borders included.
 	*
-	* @param normalizedMouseX Normalized X position of the mouse.
-	* @param normalizedMouseY Normalized Y position of the mouse.
+	* @param mouseX X position of the mouse in pixels.
+	* @param mouseY Y position of the mouse in pixels.
 	* @return True if the mouse is inside the object, otherwise false.
 	*/
-	bool Window::IsMouseInsideObject(float normalizedMouseX, float normalizedMouseY) const
-	{
-		return (normalizedMouseX >= m_WindowLimits[1] - epsilon &&
-			normalizedMouseX <= m_WindowLimits[0] + epsilon &&
-			normalizedMouseY >= m_WindowLimits[3] - epsilon &&
-			normalizedMouseY <= m_WindowLimits[2] + epsilon);
-	}
-
-	bool Window::CheckSlide(float normalizedMouseX, float  normalizedMouseY)
+	bool Window::IsMouseInsideObject(float mouseX, float mouseY) const
 	{
-		if (m_SliderEnable && IsMouseInsideObject(normalizedMouseX, normalizedMouseY) && m_dragging)
-		{
-			bool IsBeforeRx = normalizedMouseX < m_SlideLimits[0] + m_SliderModel[3].x;
-			bool IsAfterLx = normalizedMouseX > m_SlideLimits[1] + m_SliderModel[3].x;
-			bool IsBelowUy = normalizedMouseY < m_SlideLimits[2] + m_SliderModel[3].y;
-			bool IsAboveDy = normalizedMouseY > m_SlideLimits[3] + m_SliderModel[3].y;
-
-			return (IsBeforeRx && IsAfterLx && IsAboveDy && IsBelowUy);
-
-		}
-		return false;
+		return (mouseX >= m_bounds.left - BorderGrab &&
+			mouseX <= m_bounds.right + BorderGrab &&
+			mouseY >= m_bounds.top - BorderGrab &&
+			mouseY <= m_bounds.bottom + BorderGrab);
 	}
 
 } // namespace Vicetrice
\ No newline at end of file
@@ -6,9 +6,19 @@
 #include "IndexBuffer.hpp"
 #include "Shader.hpp"
 #include "VertexArray.hpp"
+#include "StreamBuffer.hpp"
+#include "DamageRegion.hpp"
+#include "Widget.hpp"
+#include "ListView.hpp"
+#include "ScrollBar.hpp"
 #include <string>
+#include <memory>
 
 #include "Icon.hpp"
+#include "IconSource.hpp"
+#include "IconStore.hpp"
+#include "TextureAtlas.hpp"
+#include "Font.hpp"
 
 namespace Vicetrice
 {
@@ -30,6 +40,12 @@ namespace Vicetrice
 
 	/**
 	 * @brief Class representing a window with icons that can be dragged, resized, and rendered.
+	 *
+	 * The window is a WidgetTree laid out in pixels of the context: a panel with a header strip, then
+	 * a ListView of the rows at a fixed height next to a ScrollBar. Everything is drawn through one
+	 * orthographic projection, so the rows keep their size when the context or the window changes
+	 * shape. An event only lays out and tessellates the widgets it changed: resizing lays out the
+	 * window, scrolling only touches the rows and the slider.
 	 */
 	class Window
 	{
@@ -41,9 +57,9 @@ namespace Vicetrice
 		 *
 		 * @param ContextWidth Width of the context (window).
 		 * @param ContextHeight Height of the context (window).
-		 * @param shPath Path to the shader files.
+		 * @param standalone False for a window drawn by a WindowManager, no GL object is created for it.
 		 */
-		Window(int ContextWidth, int ContextHeight);
+		Window(int ContextWidth, int ContextHeight, bool standalone = true);
 
 		/**
 		 * @brief Destructor for the Window class.
@@ -51,7 +67,7 @@ namespace Vicetrice
 		~Window();
 
 		/**
-		 * @brief Adjusts the projection matrix based on the new context dimensions.
+		 * @brief Adjusts the projection matrix based on the new context dimensions, the window keeps its size in pixels.
 		 *
 		 * @param ContextWidth New width of the context.
 		 * @param ContextHeight New height of the context.
@@ -67,6 +83,17 @@ namespace Vicetrice
 		 */
 		void DragON(GLFWwindow* context, int button, int action);
 
+		/**
+		 * @brief Enables or disables dragging of the window at a given mouse position.
+		 *
+		 * @param context Pointer to the GLFW window context, may be null when running headless.
+		 * @param button Mouse button involved in the action.
+		 * @param action Action taken (e.g., press, release).
+		 * @param mouseX X position of the mouse.
+		 * @param mouseY Y position of the mouse.
+		 */
+		void DragON(GLFWwindow* context, int button, int action, double mouseX, double mouseY);
+
 		/**
 		 * @brief Moves the window based on the mouse position.
 		 *
@@ -76,14 +103,70 @@ namespace Vicetrice
 		void Move(double xpos, double ypos);
 
 		/**
-		 * @brief Draws the window and its icons on the screen.
+		 * @brief Draws the window and its icons on the screen, nothing for a window drawn by a WindowManager.
 		 */
 		void Draw();
 
+		/**
+		 * @brief Floats of each rectangle written by WriteBatch: rect (left, bottom, right, top), color and clip rect, in NDC, and image.
+		 */
+		static const unsigned int BatchFloats = WidgetTree::BatchFloats;
+
+		/**
+		 * @brief Rectangles WriteBatch writes: the panel, the visible rows and the slider.
+		 */
+		unsigned int BatchInstances() const;
+
+		/**
+		 * @brief Writes the window as rectangles of the batch shader, back to front, copied from the widgets.
+		 *
+		 * @param out Room for BatchInstances() * BatchFloats floats.
+		 * @return One past the last float written.
+		 */
+		float* WriteBatch(float* out) const;
+
+		/**
+		 * @brief Checks if a mouse position falls on the window.
+		 *
+		 * @param mouseX X position of the mouse.
+		 * @param mouseY Y position of the mouse.
+		 */
+		bool Contains(double mouseX, double mouseY) const;
+
+		/**
+		 * @brief Rectangle where Contains is true, in mouse coordinates (y grows downwards).
+		 */
+		void Bounds(double& left, double& top, double& right, double& bottom) const;
+
+		/**
+		 * @brief Returned by IconAt when no row is under the position.
+		 */
+		static const unsigned int NoIcon = ~0u;
+
+		/**
+		 * @brief Index in the source of the visible row under a mouse position.
+		 *
+		 * The rows are stacked at a fixed height, the row is computed from the position instead of
+		 * testing each of them.
+		 *
+		 * @return The row, or NoIcon over the slider, the borders or outside the window.
+		 */
+		unsigned int IconAt(double mouseX, double mouseY) const;
+
+		/**
+		 * @brief Places the top left corner of the window, in pixels of the context.
+		 */
+		void SetPosition(float left, float top);
+
+		/**
+		 * @brief Damages the bounds of the window, e.g. when it is raised over others.
+		 */
+		void Invalidate();
+
 		/**
 		 * @brief Resizes the window based on mouse position.
 		 *
-		 * @param context Pointer to the GLFW window context.
+		 * @param context Pointer to the GLFW window context, may be null when running headless.
 		 * @param xpos X position of the mouse.
 		 * @param ypos Y position of the mouse.
 		 */
@@ -91,14 +174,50 @@ namespace Vicetrice
 
 		/**
 		 * @brief Adds an icon to the window.
+		 *
+		 * @param image Image of the icon in the atlas of the window, see SetAtlas.
+		 * @param label Text of the row, UTF-8, see SetFont.
 		 */
-		void addIcon();
+		void addIcon(unsigned int image = TextureAtlas::NoImage, const std::string& label = std::string());
 
 		/**
 		 * @brief Removes an icon from the window.
 		 */
 		void RemoveIcon();
 
+		/**
+		 * @brief Sets the atlas the images of the icons are in, a standalone window binds it to draw them.
+		 *
+		 * A WindowManager binds its own atlas, see WindowManager::SetAtlas.
+		 *
+		 * @param atlas Not owned, nullptr draws every icon flat.
+		 */
+		void SetAtlas(const TextureAtlas* atlas);
+
+		/**
+		 * @brief Sets the font of the labels of the rows, they are drawn when a WindowManager draws the window.
+		 *
+		 * The glyphs are rectangles of the batch, a standalone window draws its rows instanced and no label.
+		 *
+		 * @param font Not owned, its atlas must be the one the window is drawn with. nullptr draws no label.
+		 */
+		void SetFont(Font* font);
+
+		/**
+		 * @brief Shows the rows of another source, only the visible rows are fetched from it.
+		 *
+		 * @param source Source of the rows, nullptr goes back to the icons added with addIcon.
+		 *        The window does not take ownership.
+		 */
+		void SetSource(IconSource* source);
+
+		/**
+		 * @brief Notifies the window that rows of its source changed or were added/removed.
+		 *
+		 * @param FirstChangedRow Rows from this one on are fetched again when visible.
+		 */
+		void SourceChanged(unsigned int FirstChangedRow = 0);
+
 		/**
 		 * @brief Checks if the window is currently being dragged.
 		 *
@@ -110,23 +229,63 @@ namespace Vicetrice
 		}
 
 		/**
-		 * @brief Checks if the window is currently being rendered.
+		 * @brief Checks if the window has damage to redraw.
 		 *
-		 * @return True if the window is being rendered, otherwise false.
+		 * @return True if something changed since the last ClearDamage, otherwise false.
 		 */
 		inline bool Rendering() const
 		{
-			return m_render;
+			return !m_damage.Empty();
+		}
+
+		/**
+		 * @brief Parts of the context that changed since the last ClearDamage, in framebuffer pixels.
+		 *
+		 * Moving or resizing damages the old and new bounds of the window, scrolling the slider thumb and
+		 * the rows, and a change of the source the rows from the first changed one down.
+		 */
+		inline const DamageRegion& Damage() const
+		{
+			return m_damage;
+		}
+
+		/**
+		 * @brief Forgets the damage, call it once the frame that redrew it is presented.
+		 */
+		inline void ClearDamage()
+		{
+			m_damage.Clear();
+		}
+
+		/**
+		 * @brief Damages the whole context, the next frame redraws everything.
+		 */
+		inline void DamageAll()
+		{
+			m_damage.AddAll();
 		}
 
 		/**
-		 * @brief Returns the current model matrix of the window.
+		 * @brief Returns the matrix the window quad is drawn with, the projection of its rectangle.
 		 *
 		 * @return The model matrix.
 		 */
-		inline glm::mat4 ModelMatrix() const
+		glm::mat4 ModelMatrix() const;
+
+		/**
+		 * @brief Rectangle of the window in pixels of the context.
+		 */
+		inline const LayoutRect& Rect() const
 		{
-			return m_model;
+			return m_bounds;
+		}
+
+		/**
+		 * @brief Widgets of the window, with the counters of their layouts and tessellations.
+		 */
+		inline const WidgetTree& Widgets() const
+		{
+			return m_tree;
 		}
 
 		/**
@@ -156,11 +315,14 @@ namespace Vicetrice
 
 		//---------------------------------------- ATTRIBUTES
 
-		glm::mat4 m_model;             /// Model matrix of the window.
-		glm::mat4 m_proj;              /// Projection matrix of the window.
+		LayoutRect m_bounds;           /// Rectangle of the window in pixels of the context.
+		glm::mat4 m_proj;              /// Orthographic projection from pixels of the context to clip space.
+		WidgetTree m_tree;             /// Panel, header, rows and slider of the window, laid out in m_bounds.
+		ListView* m_rows;              /// Rows of the source, owned by m_tree.
+		ScrollBar* m_slider;           /// Slider of the rows, owned by m_tree.
 
 		bool m_dragging;               /// Flag indicating if the window is being dragged.
-		bool m_render;                 /// Flag indicating if the window is being rendered.
+		DamageRegion m_damage;         /// Parts of the context to redraw.
 
 		int m_ContextWidth;            /// Width of the window context.
 		int m_ContextHeight;           /// Height of the window context.
@@ -171,57 +333,29 @@ namespace Vicetrice
 		ResizeTypes m_resize;          /// Current resize type.
 		bool m_moving;                 /// Flag indicating if the window is moving.
 
-		std::vector<float> m_vertex;   /// Vertex data of the window.
+		std::vector<float> m_vertex;   /// Vertex data of the window, a unit quad placed by ModelMatrix.
 		std::vector<unsigned int> m_indices; /// Index data of the window.
 
-		unsigned int m_IndexToFirstIconToRender; /// Index of the first icon to be rendered.
-		unsigned int m_MaxIconsToRender; /// Maximum number of icons to render.
-
-		float m_WindowLimits[4];       /// Array containing the window limits.
-
-		// Window
-		VertexArray m_va;              /// Vertex array object for the window.
-		VertexBuffer m_vb;             /// Vertex buffer object for the window.
-		Shader m_shader;               /// Shader object for the window.
-		IndexBuffer m_ib;              /// Index buffer object for the window.
-
-		// Icons
-		VertexArray m_vaI;             /// Vertex array object for the icons.
-		VertexBuffer m_vbI;            /// Vertex buffer object for the icons.
-		Shader m_shaderI;              /// Shader object for the icons.
-		IndexBuffer m_ibI;             /// Index buffer object for the icons.
-
-		std::vector<Icon> m_icons;     /// Vector containing all icons in the window.
-
+		struct Resources;
+		std::unique_ptr<Resources> m_resources; /// GL objects of a standalone window, null when a WindowManager draws it.
 
-		bool m_SliderEnable;
-		float m_SlideLimits[4];
+		IconStore m_list;              /// Icons added with addIcon, default source of the window.
 
-		// TODO: ADD TO SLIDERICON CLASS
-		glm::mat4 m_SliderModel;
-		bool m_sliding;
+		unsigned int m_StreamInstance;            /// Instance of the slider in the instance stream, the visible rows follow it.
+		unsigned long long m_StreamRevision;      /// ListView::Revision of the rows in the instance stream.
+		const TextureAtlas* m_atlas;   /// Images of the icons, not owned.
 
 
 		//---------------------------------------- PRIVATE METHODS
 
 		/**
-		 * @brief Normalizes mouse coordinates from screen space to OpenGL space.
+		 * @brief Checks if the mouse is inside the window's object, its borders included.
 		 *
-		 * @param mouseX X position of the mouse in screen space.
-		 * @param mouseY Y position of the mouse in screen space.
-		 * @param normalizedX Reference to store the normalized X position.
-		 * @param normalizedY Reference to store the normalized Y position.
-		 */
-		void NormalizeMouseCoords(double mouseX, double mouseY, float& normalizedX, float& normalizedY) const;
-
-		/**
-		 * @brief Checks if the mouse is inside the window's object.
-		 *
-		 * @param normalizedMouseX Normalized X position of the mouse.
-		 * @param normalizedMouseY Normalized Y position of the mouse.
+		 * @param mouseX X position of the mouse in pixels.
+		 * @param mouseY Y position of the mouse in pixels.
 		 * @return True if the mouse is inside the object, otherwise false.
 		 */
-		bool IsMouseInsideObject(float normalizedMouseX, float normalizedMouseY) const;
+		bool IsMouseInsideObject(float mouseX, float mouseY) const;
 
 		/**
 		 * @brief Helper function to check if a point is within limits, considering a tolerance (epsilon).
@@ -241,14 +375,44 @@ namespace Vicetrice
 		 */
 		void DrawIcon();
 
+		/**
+		 * @brief Damages a rectangle of the context, padded to whole pixels.
+		 */
+		void DamageRect(const LayoutRect& rect);
+
+		/**
+		 * @brief Damages the current bounds of the window.
+		 */
+		void DamageWindow();
+
+		/**
+		 * @brief Damages the current slider thumb, if the slider is shown.
+		 */
+		void DamageSlider();
+
+		/**
+		 * @brief Damages the rows from the given one down to the bottom of the window.
+		 *
+		 * @param row Row of the source, rows above the first visible one damage from the top.
+		 */
+		void DamageRows(unsigned int row);
+
 		/**
 		 * @brief Checks and adjusts the window resizing based on mouse position.
 		 *
 		 * @param context Pointer to the GLFW window context.
-		 * @param normalizedMouseX Normalized X position of the mouse.
-		 * @param normalizedMouseY Normalized Y position of the mouse.
+		 * @param mouseX X position of the mouse in pixels.
+		 * @param mouseY Y position of the mouse in pixels.
+		 */
+		void CheckResize(GLFWwindow* context, float mouseX, float mouseY);
+
+		/**
+		 * @brief Sets one of the GLFW standard cursors on the context.
+		 *
+		 * @param context Pointer to the GLFW window context, nothing is done when it is null (headless runs).
+		 * @param shape GLFW standard cursor shape, 0 restores the default cursor.
 		 */
-		void CheckResize(GLFWwindow* context, float normalizedMouseX, float normalizedMouseY);
+		void SetCursor(GLFWwindow* context, int shape) const;
 
 		/**
 		 * @brief Initializes the vertex data for the window.
@@ -264,17 +428,47 @@ namespace Vicetrice
 		 */
 		unsigned int* IniIndex();
 
+		/**
+		 * @brief Creates the widgets of the window.
+		 */
+		void BuildWidgets();
+
 		/**
 		 * @brief Renders an icon on the window.
 		 */
 		void RenderIcon();
 
 		/**
-		 * @brief Updates the limits of the window based on its current position and size.
+		 * @brief Lays out and tessellates the widgets that changed, nothing is done when none did.
+		 */
+		void UpdateLayout();
+
+		/**
+		 * @brief Draws a run of consecutive instances of the icon VAO.
+		 *
+		 * @param FirstInstance First instance of the stream buffer to draw.
+		 * @param count Number of instances.
+		 */
+		void DrawInstances(unsigned int FirstInstance, unsigned int count);
+
+		/**
+		 * @brief Writes the slider and the visible rows, in order, to the next range of the stream buffer if they changed.
 		 */
-		void updateLimits();
+		void StreamInstances();
 
-		bool CheckSlide(float normalizedMouseX, float  normalizedMouseY);
+		/**
+		 * @brief Builds the matrix that maps icon space (unit width and height rows going down from 0) onto the rows box.
+		 *
+		 * @return The model matrix for the icon rows.
+		 */
+		glm::mat4 IconMatrix() const;
+
+		/**
+		 * @brief Builds the matrix that maps the unit slider quad onto the slider thumb.
+		 *
+		 * @return The model matrix for the slider.
+		 */
+		glm::mat4 SliderMatrix() const;
 
 	}; // class Window
 
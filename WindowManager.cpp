@@ -0,0 +1,315 @@
+#include "WindowManager.hpp"
+#include "Backend.hpp"
+#include "Profiler.hpp"
+#include "ShaderCache.hpp"
+#include "TextureAtlas.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+
+namespace Vicetrice
+{
+	static const unsigned int IndicesPerRect = 6;
+	static const unsigned int BatchSegment = 64 * 1024; // bytes, about 1300 rectangles
+
+	static const float UnitQuad[] =
+	{
+		//Position
+		0.0f, 0.0f,	// LD
+		1.0f, 0.0f,	// RD
+		1.0f, 1.0f,	// RU
+		0.0f, 1.0f	// LU
+	};
+
+
+	WindowManager::WindowManager(int ContextWidth, int ContextHeight)
+		: m_windows{},
+		m_active{ nullptr },
+		m_hovered{ nullptr },
+		m_ContextWidth{ ContextWidth },
+		m_ContextHeight{ ContextHeight },
+		m_damage{},
+		m_hits{},
+		m_exposed{ false },
+		m_va{},
+		m_vb{ UnitQuad, sizeof(UnitQuad) },
+		m_ib{ IndexBuffer::QuadPattern(1).data(), IndicesPerRect * sizeof(unsigned int) },
+		m_shader{ ShaderCache::Get("res/shaders/Batch.shader") },
+		m_stream{ BatchSegment },
+		m_InstanceLayout{ 1 },
+		m_InstanceAttrib{ 0 },
+		m_BatchFirst{ 0 },
+		m_BatchCount{ 0 },
+		m_BatchDirty{ true },
+		m_atlas{ nullptr },
+		m_font{ nullptr }
+	{
+		VertexBufferLayout QuadLayout;
+
+		QuadLayout.Push<float>(2);
+
+		//Rect, color, clip rect and image, Window::BatchFloats in total
+		m_InstanceLayout.Push<float>(4);
+		m_InstanceLayout.Push<float>(4);
+		m_InstanceLayout.Push<float>(4);
+		m_InstanceLayout.Push<float>(1);
+
+		m_va.addBuffer(m_vb, QuadLayout);
+		m_InstanceAttrib = m_va.addBuffer(m_stream.Buffer(), m_InstanceLayout);
+
+		TextureAtlas::BindBlock(*m_shader);
+
+		m_damage.SetBounds(ContextWidth, ContextHeight);
+		m_damage.AddAll();
+	}
+
+	WindowManager::~WindowManager()
+	{
+	}
+
+	Window& WindowManager::Create()
+	{
+		m_windows.push_back(std::make_unique<Window>(m_ContextWidth, m_ContextHeight, false));
+		m_BatchDirty = true;
+
+		Window& window = *m_windows.back();
+		window.SetFont(m_font);
+		window.ClearDamage();
+		window.Invalidate();
+		Collect(window);
+
+		m_exposed = true;
+		return window;
+	}
+
+	void WindowManager::Destroy(const Window& window)
+	{
+		auto it = std::find_if(m_windows.begin(), m_windows.end(), [&window](const std::unique_ptr<Window>& w) { return w.get() == &window; });
+		if (it == m_windows.end())
+			return;
+
+		// What was under it shows again
+		(*it)->Invalidate();
+		Collect(**it);
+
+		if (m_active == it->get())
+			m_active = nullptr;
+		if (m_hovered == it->get())
+			m_hovered = nullptr;
+
+		m_hits.Remove(it->get());
+		m_windows.erase(it);
+		m_BatchDirty = true;
+	}
+
+	void WindowManager::AdjustProj(int ContextWidth, int ContextHeight)
+	{
+		m_ContextWidth = ContextWidth;
+		m_ContextHeight = ContextHeight;
+
+		for (std::unique_ptr<Window>& window : m_windows)
+		{
+			window->AdjustProj(ContextWidth, ContextHeight);
+			window->ClearDamage();
+			Index(*window);
+		}
+
+		m_damage.SetBounds(ContextWidth, ContextHeight);
+		m_damage.AddAll();
+		m_BatchDirty = true;
+	}
+
+	void WindowManager::CursorPosition(GLFWwindow* context, double xpos, double ypos)
+	{
+		VICE_PROFILE_ZONE("WindowManager::CursorPosition");
+
+		Window* target = m_active;
+
+		if (target == nullptr)
+		{
+			target = WindowAt(xpos, ypos);
+
+			// The window left behind restores the cursor it set
+			if (m_hovered != nullptr && m_hovered != target)
+				m_hovered->Resize(context, xpos, ypos);
+			m_hovered = target;
+		}
+
+		if (target == nullptr)
+			return;
+
+		target->Resize(context, xpos, ypos);
+		target->Move(xpos, ypos);
+		Collect(*target);
+	}
+
+	void WindowManager::MouseButton(GLFWwindow* context, int button, int action, double mouseX, double mouseY)
+	{
+		if (m_active == nullptr)
+		{
+			if (action != GLFW_PRESS)
+				return;
+
+			Window* target = WindowAt(mouseX, mouseY);
+			if (target == nullptr)
+				return;
+
+			Raise(*target);
+			target->DragON(context, button, action, mouseX, mouseY);
+			Collect(*target);
+
+			if (target->Dragging())
+				m_active = target;
+			return;
+		}
+
+		m_active->DragON(context, button, action, mouseX, mouseY);
+		Collect(*m_active);
+
+		if (!m_active->Dragging())
+			m_active = nullptr;
+	}
+
+	void WindowManager::Draw()
+	{
+		VICE_PROFILE_ZONE("WindowManager::Draw");
+
+		Collect();
+
+		if (m_BatchDirty)
+		{
+			unsigned int count = 0;
+			for (const std::unique_ptr<Window>& window : m_windows)
+				count += window->BatchInstances();
+
+			const unsigned int stride = Window::BatchFloats * sizeof(float);
+			float* out = static_cast<float*>(m_stream.Map(count * stride, stride));
+
+			for (const std::unique_ptr<Window>& window : m_windows)
+				out = window->WriteBatch(out);
+
+			m_BatchFirst = m_stream.Commit() / stride;
+			m_BatchCount = count;
+			m_BatchDirty = false;
+			VICE_PROFILE_COUNT(InstancesUploaded, count);
+		}
+
+		if (m_BatchCount == 0)
+			return;
+
+		m_shader->Bind();
+		m_va.Bind();
+		m_ib.Bind();
+
+		// The images of every window are in the same texture
+		if (m_atlas != nullptr)
+			m_atlas->Bind();
+
+		m_va.SetFirstInstance(m_stream.Buffer(), m_InstanceLayout, m_InstanceAttrib, m_BatchFirst);
+		Backend::Get().DrawElementsInstanced(GL_TRIANGLES, IndicesPerRect, GL_UNSIGNED_INT, 0, static_cast<int>(m_BatchCount));
+		VICE_PROFILE_COUNT(DrawCalls, 1);
+	}
+
+	void WindowManager::SetAtlas(const TextureAtlas* atlas)
+	{
+		m_atlas = atlas;
+		DamageAll();
+	}
+
+	void WindowManager::SetFont(Font* font)
+	{
+		m_font = font;
+
+		// Only the rows are tessellated again, each window damages them
+		for (std::unique_ptr<Window>& window : m_windows)
+		{
+			window->SetFont(font);
+			Collect(*window);
+		}
+	}
+
+	WindowManager::Hit WindowManager::HitTest(double mouseX, double mouseY)
+	{
+		Hit hit;
+
+		hit.window = WindowAt(mouseX, mouseY);
+		if (hit.window != nullptr)
+			hit.icon = hit.window->IconAt(mouseX, mouseY);
+		return hit;
+	}
+
+	bool WindowManager::Rendering()
+	{
+		Collect();
+		return !m_damage.Empty();
+	}
+
+	const DamageRegion& WindowManager::Damage()
+	{
+		Collect();
+		return m_damage;
+	}
+
+	void WindowManager::ClearDamage()
+	{
+		m_damage.Clear();
+	}
+
+	void WindowManager::DamageAll()
+	{
+		m_damage.AddAll();
+		m_BatchDirty = true;
+	}
+
+	void WindowManager::Collect(Window& window)
+	{
+		const DamageRegion& damage = window.Damage();
+		if (damage.Empty())
+			return;
+
+		for (const DamageRect& rect : damage.Rects())
+			m_damage.Add(rect.x, rect.y, rect.width, rect.height);
+
+		window.ClearDamage();
+		m_BatchDirty = true;
+
+		// Moves and resizes damage the window, so its bounds are only looked at here
+		Index(window);
+	}
+
+	void WindowManager::Collect()
+	{
+		for (std::unique_ptr<Window>& window : m_windows)
+			Collect(*window);
+		m_exposed = false;
+	}
+
+	void WindowManager::Index(Window& window)
+	{
+		double left, top, right, bottom;
+		window.Bounds(left, top, right, bottom);
+		m_hits.Update(&window, left, top, right, bottom);
+	}
+
+	Window* WindowManager::WindowAt(double mouseX, double mouseY)
+	{
+		// Windows changed through a reference the manager handed out are indexed first
+		if (m_exposed)
+			Collect();
+
+		return m_hits.At(mouseX, mouseY);
+	}
+
+	void WindowManager::Raise(Window& window)
+	{
+		if (m_windows.back().get() == &window)
+			return;
+
+		auto it = std::find_if(m_windows.begin(), m_windows.end(), [&window](const std::unique_ptr<Window>& w) { return w.get() == &window; });
+		std::rotate(it, it + 1, m_windows.end());
+		m_hits.Raise(&window);
+
+		window.Invalidate();
+		Collect(window);
+	}
+
+} // namespace Vicetrice
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <memory>
+#include <vector>
+#include "Window.hpp"
+#include "VertexArray.hpp"
+#include "VertexBuffer.hpp"
+#include "VertexBufferLayout.hpp"
+#include "IndexBuffer.hpp"
+#include "Shader.hpp"
+#include "StreamBuffer.hpp"
+#include "DamageRegion.hpp"
+#include "HitGrid.hpp"
+#include "TextureAtlas.hpp"
+
+namespace Vicetrice
+{
+	/**
+	 * @brief Holds many Window panels and draws all of them with a single draw call.
+	 *
+	 * The windows create no GL objects of their own. Every panel, row and slider is a rectangle of
+	 * one shared shader, written back to front into one stream buffer, so the z-order is the order
+	 * of the instances and blending stays correct. The images of the icons and the glyphs of their
+	 * labels come from one TextureAtlas, so they take no extra draw call or texture bind. Input goes to the topmost window under the cursor,
+	 * a press raises it and it keeps the events until the release. The window under the cursor is
+	 * found in a HitGrid, not by testing every window.
+	 */
+	class WindowManager
+	{
+	public:
+
+		/**
+		 * @param ContextWidth Width of the context.
+		 * @param ContextHeight Height of the context.
+		 */
+		WindowManager(int ContextWidth, int ContextHeight);
+
+		~WindowManager();
+
+		WindowManager(const WindowManager&) = delete;
+		WindowManager& operator=(const WindowManager&) = delete;
+
+		/**
+		 * @brief Creates a window on top of the others.
+		 *
+		 * @return The window, valid until Destroy or the manager goes away.
+		 */
+		Window& Create();
+
+		/**
+		 * @brief Destroys a window created by this manager.
+		 */
+		void Destroy(const Window& window);
+
+		inline std::size_t Count() const { return m_windows.size(); }
+
+		/**
+		 * @brief Window at a position of the z-order, 0 is the bottom.
+		 */
+		inline Window& At(std::size_t index) { m_exposed = true; return *m_windows[index]; }
+
+		/**
+		 * @brief Topmost window, the manager must not be empty.
+		 */
+		inline Window& Top() { m_exposed = true; return *m_windows.back(); }
+
+		/**
+		 * @brief Sets the atlas the images of the icons of every window are in, bound once per Draw.
+		 *
+		 * @param atlas Not owned, nullptr draws every icon flat.
+		 */
+		void SetAtlas(const TextureAtlas* atlas);
+
+		/**
+		 * @brief Sets the font of the labels of every window, the ones created later included.
+		 *
+		 * The glyphs are drawn in the same batch as the rows, so the font must rasterize into the atlas of SetAtlas.
+		 *
+		 * @param font Not owned, nullptr draws no label.
+		 */
+		void SetFont(Font* font);
+
+		/**
+		 * @brief What is under a mouse position.
+		 */
+		struct Hit
+		{
+			Window* window = nullptr;          /// Topmost window under the position, nullptr if none.
+			unsigned int icon = Window::NoIcon; /// Row of that window under the position, see Window::IconAt.
+		};
+
+		/**
+		 * @brief Finds the topmost window and the row of it under a mouse position.
+		 */
+		Hit HitTest(double mouseX, double mouseY);
+
+		/**
+		 * @brief Adjusts every window to new context dimensions.
+		 */
+		void AdjustProj(int ContextWidth, int ContextHeight);
+
+		/**
+		 * @brief Dispatches a cursor move, what main.cpp does for a single window with Resize and Move.
+		 *
+		 * @param context Pointer to the GLFW window context, may be null when running headless.
+		 */
+		void CursorPosition(GLFWwindow* context, double xpos, double ypos);
+
+		/**
+		 * @brief Dispatches a button transition, a press raises the topmost window under the cursor.
+		 *
+		 * @param context Pointer to the GLFW window context, may be null when running headless.
+		 */
+		void MouseButton(GLFWwindow* context, int button, int action, double mouseX, double mouseY);
+
+		/**
+		 * @brief Draws every window, back to front, with one instanced draw call.
+		 *
+		 * The rectangles are written again only when a window was damaged, so calling it once per
+		 * damaged rectangle of a frame costs one upload.
+		 */
+		void Draw();
+
+		/**
+		 * @brief Checks if any window has damage to redraw.
+		 */
+		bool Rendering();
+
+		/**
+		 * @brief Damage of every window, in framebuffer pixels.
+		 */
+		const DamageRegion& Damage();
+
+		/**
+		 * @brief Forgets the damage, call it once the frame that redrew it is presented.
+		 */
+		void ClearDamage();
+
+		/**
+		 * @brief Damages the whole context, the next frame redraws everything.
+		 */
+		void DamageAll();
+
+	private:
+		std::vector<std::unique_ptr<Window>> m_windows; /// Back to front.
+		Window* m_active;              /// Window that got the press, it receives the events until the release.
+		Window* m_hovered;             /// Window under the cursor at the last move.
+		int m_ContextWidth;
+		int m_ContextHeight;
+		DamageRegion m_damage;         /// Damage collected from the windows.
+		HitGrid<Window> m_hits;        /// Bounds of the windows, stacked like m_windows.
+		bool m_exposed;                /// A window was handed out by Create, At or Top and may have changed since the last Collect.
+
+		VertexArray m_va;              /// Unit quad and the per-instance rectangles.
+		VertexBuffer m_vb;             /// Unit quad shared by every rectangle.
+		IndexBuffer m_ib;              /// Index buffer object for the unit quad.
+		std::shared_ptr<Shader> m_shader; /// Batch shader, shared by every window.
+		StreamBuffer m_stream;         /// Rectangles of the last Draw.
+		VertexBufferLayout m_InstanceLayout; /// Layout of the rectangles.
+		unsigned int m_InstanceAttrib; /// Location of the first per-instance attribute in m_va.
+		unsigned int m_BatchFirst;     /// First instance of the rectangles in m_stream.
+		unsigned int m_BatchCount;     /// Number of rectangles in m_stream.
+		bool m_BatchDirty;             /// A window changed since the rectangles were written.
+		const TextureAtlas* m_atlas;   /// Images of the icons, not owned.
+		Font* m_font;                  /// Font of the labels, not owned.
+
+		/**
+		 * @brief Moves the damage of a window into the damage of the manager, a damaged window is indexed again.
+		 */
+		void Collect(Window& window);
+
+		/**
+		 * @brief Collects the damage of every window, changes made on them directly are seen this way.
+		 */
+		void Collect();
+
+		/**
+		 * @brief Updates the bounds of a window in m_hits.
+		 */
+		void Index(Window& window);
+
+		/**
+		 * @brief Topmost window under the cursor, nullptr if none.
+		 */
+		Window* WindowAt(double mouseX, double mouseY);
+
+		/**
+		 * @brief Moves a window to the top of the z-order.
+		 */
+		void Raise(Window& window);
+
+	}; // class WindowManager
+
+} // namespace Vicetrice
@@ -0,0 +1,823 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#ifdef VICE_BENCH_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#include "Window.hpp"
+#include "Backend.hpp"
+#include "RecordingBackend.hpp"
+#include "Error.hpp"
+#include "InputQueue.hpp"
+#include "WindowManager.hpp"
+#include "InstanceGenerator.hpp"
+#include "TextureAtlas.hpp"
+#include "ImageLoader.hpp"
+#include "Font.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Headless benchmark of the Window event handlers.
+// Runs on an EGL surfaceless context (Mesa llvmpipe works) with an offscreen framebuffer bound,
+// or with --null on the recording backend alone, without any GL at all (the only mode when built without EGL).
+// The same calls main.cpp makes for each event are scripted and timed, uploads and draws
+// are counted by a RecordingBackend in front of the real one, and the pixels each event damages by the Window.
+
+namespace
+{
+	const int ContextWidth = 800;
+	const int ContextHeight = 800;
+
+	// A 1000 Hz mouse at 60 frames per second
+	const unsigned int SamplesPerFrame = 16;
+
+	// The first of these that loads draws the labels, the text scenarios are skipped without any
+	const char* FontPaths[] =
+	{
+		"res/fonts/Label.ttf",
+		"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+		"/System/Library/Fonts/Supplemental/Arial.ttf",
+		"C:/Windows/Fonts/segoeui.ttf"
+	};
+
+	std::size_t s_Allocations = 0;
+
+	Vicetrice::RecordingBackend* s_Recorder = nullptr;
+	bool s_Null = false;
+
+
+#ifdef VICE_BENCH_EGL
+	/**
+	 * @brief Creates a surfaceless OpenGL 3.3 core context and binds an offscreen framebuffer to it.
+	 *
+	 * @return True if the context is current and GLEW is initialized.
+	 */
+	bool CreateHeadlessContext()
+	{
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+			reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		EGLDisplay display = getPlatformDisplay != nullptr
+			? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+			: eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+		EGLint major, minor;
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API))
+		{
+			std::cout << "EGL initialization failed: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+			return false;
+		}
+
+		const EGLint attributes[] = {
+			EGL_CONTEXT_MAJOR_VERSION, 3,
+			EGL_CONTEXT_MINOR_VERSION, 3,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+
+		EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+		if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+		{
+			std::cout << "EGL context creation failed: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+			return false;
+		}
+
+		glewExperimental = GL_TRUE;
+		GLenum status = glewInit();
+		//GLEW built for GLX loads the core entry points before failing to find a GLX display
+		if (status != GLEW_OK && status != GLEW_ERROR_NO_GLX_DISPLAY)
+		{
+			std::cout << "GLEW initialization failed: " << glewGetErrorString(status) << std::endl;
+			return false;
+		}
+		while (glGetError() != GL_NO_ERROR);
+
+		unsigned int fbo, color;
+		GLCall(glGenRenderbuffers(1, &color));
+		GLCall(glBindRenderbuffer(GL_RENDERBUFFER, color));
+		GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, ContextWidth, ContextHeight));
+		GLCall(glGenFramebuffers(1, &fbo));
+		GLCall(glBindFramebuffer(GL_FRAMEBUFFER, fbo));
+		GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color));
+		GLCall(glViewport(0, 0, ContextWidth, ContextHeight));
+
+		std::cout << "Using GL Version: " << glGetString(GL_VERSION) << " (" << glGetString(GL_RENDERER) << ")" << std::endl;
+
+		return true;
+	}
+#else
+	bool CreateHeadlessContext()
+	{
+		std::cout << "Built without EGL, run with --null" << std::endl;
+		return false;
+	}
+#endif
+
+
+	// Normalized window coordinates to the pixel coordinates GLFW reports
+	double PixelX(float x) { return (x + 1.0) * 0.5 * ContextWidth; }
+	double PixelY(float y) { return (1.0 - y) * 0.5 * ContextHeight; }
+
+
+	/**
+	 * @brief Counters of one scenario, the deltas are taken around the scripted events only.
+	 */
+	class Measure
+	{
+	public:
+		Measure(const char* scenario, Vicetrice::Window* window, unsigned int icons)
+			: m_scenario{ scenario }, m_window{ window }, m_icons{ icons }, m_events{ 0 }, m_damaged{ 0 },
+			m_allocations{ s_Allocations }, m_stats{ s_Recorder->Stats() },
+			m_start{ std::chrono::steady_clock::now() }
+		{
+			if (m_window != nullptr)
+				m_window->ClearDamage();
+		}
+
+		/**
+		 * @brief Counts many events at once, for scenarios timed over a whole batch.
+		 */
+		inline void Events(unsigned int count)
+		{
+			m_events += count;
+		}
+
+		inline void Event()
+		{
+			++m_events;
+			if (m_window != nullptr)
+			{
+				m_damaged += m_window->Damage().Area();
+				m_window->ClearDamage();
+			}
+		}
+
+		void Report()
+		{
+			if (!s_Null)
+				glFinish();
+			double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+			double events = m_events == 0 ? 1.0 : static_cast<double>(m_events);
+			const Vicetrice::BackendStats& stats = s_Recorder->Stats();
+
+			std::cout << std::left << std::setw(10) << m_scenario
+				<< std::right << std::setw(8) << m_icons
+				<< std::setw(9) << m_events
+				<< std::fixed << std::setprecision(1)
+				<< std::setw(14) << ns / events
+				<< std::setw(14) << static_cast<double>(stats.BytesUploaded - m_stats.BytesUploaded) / events
+				<< std::setprecision(2)
+				<< std::setw(14) << static_cast<double>(stats.Uploads - m_stats.Uploads) / events
+				<< std::setw(14) << static_cast<double>(stats.DrawCalls - m_stats.DrawCalls) / events
+				<< std::setw(14) << static_cast<double>(s_Allocations - m_allocations) / events
+				<< std::setprecision(0)
+				<< std::setw(14) << static_cast<double>(m_damaged) / events
+				<< std::endl;
+		}
+
+	private:
+		const char* m_scenario;
+		Vicetrice::Window* m_window;
+		unsigned int m_icons;
+		unsigned int m_events;
+		long long m_damaged;
+		std::size_t m_allocations;
+		Vicetrice::BackendStats m_stats;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+
+	/**
+	 * @brief Feeds a cursor position the way the main loop does.
+	 */
+	void CursorTo(Vicetrice::Window& window, float x, float y)
+	{
+		window.Resize(nullptr, PixelX(x), PixelY(y));
+		window.Move(PixelX(x), PixelY(y));
+	}
+
+
+	/**
+	 * @brief Presses at a point, follows a path of cursor positions and releases back at the start,
+	 * so every scenario leaves the window as it found it.
+	 */
+	template <typename Path>
+	void Drag(Vicetrice::Window& window, Measure& measure, float x, float y, unsigned int steps, Path path)
+	{
+		CursorTo(window, x, y);
+		window.DragON(nullptr, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, PixelX(x), PixelY(y));
+		measure.Event();
+
+		float px = x, py = y;
+		for (unsigned int i = 0; i < steps; i++)
+		{
+			path(i, px, py);
+			CursorTo(window, px, py);
+			measure.Event();
+		}
+
+		CursorTo(window, x, y);
+		window.DragON(nullptr, GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE, PixelX(x), PixelY(y));
+		measure.Event();
+	}
+
+
+	// Triangle wave between 0 and 1
+	float Wave(unsigned int i, unsigned int period)
+	{
+		float t = static_cast<float>(i % period) / static_cast<float>(period);
+		return t < 0.5f ? t * 2.0f : 2.0f - t * 2.0f;
+	}
+
+
+	/**
+	 * @brief Layouts and tessellations of the widgets of a window, reported after a scenario.
+	 */
+	struct WidgetWork
+	{
+		unsigned long long layouts;
+		unsigned long long tessellations;
+
+		explicit WidgetWork(const Vicetrice::Window& window)
+			: layouts{ window.Widgets().GetLayout().Computations() },
+			tessellations{ window.Widgets().Tessellations() }
+		{
+		}
+
+		void Report(const Vicetrice::Window& window) const
+		{
+			WidgetWork now(window);
+			std::cout << "          " << now.layouts - layouts << " layouts";
+			if (window.Widgets().Batched())
+				std::cout << ", " << now.tessellations - tessellations << " widgets tessellated";
+			std::cout << std::endl;
+		}
+	};
+
+
+	void Run(unsigned int icons, unsigned int steps)
+	{
+		Vicetrice::Window window(ContextWidth, ContextHeight);
+
+		{
+			Measure measure("add", &window, icons);
+			for (unsigned int i = 0; i < icons; i++)
+			{
+				window.addIcon();
+				measure.Event();
+			}
+			measure.Report();
+		}
+
+		{
+			unsigned int burst = icons < 1000 ? icons : 1000;
+			Measure measure("remove", &window, icons);
+			for (unsigned int i = 0; i < burst; i++)
+			{
+				window.RemoveIcon();
+				measure.Event();
+			}
+			for (unsigned int i = 0; i < burst; i++)
+			{
+				window.addIcon();
+				measure.Event();
+			}
+			measure.Report();
+		}
+
+		{
+			//Grab the middle of the window and move it around
+			Measure measure("drag", &window, icons);
+			WidgetWork work(window);
+			Drag(window, measure, 0.0f, 0.0f, steps, [](unsigned int i, float& x, float& y) {
+				x = 0.3f * Wave(i, 200);
+				y = 0.3f * Wave(i + 50, 200);
+				});
+			measure.Report();
+			work.Report(window);
+		}
+
+		{
+			//Grab the right edge and stretch it back and forth
+			Measure measure("resize", &window, icons);
+			WidgetWork work(window);
+			Drag(window, measure, 0.5f, 0.0f, steps, [](unsigned int i, float& x, float& y) {
+				x = 0.5f + 0.3f * Wave(i, 200);
+				});
+			measure.Report();
+			work.Report(window);
+		}
+
+		{
+			//Grab the slider thumb and scrub the whole list
+			Measure measure("scrub", &window, icons);
+			WidgetWork work(window);
+			Drag(window, measure, 0.475f, 0.39f, steps, [](unsigned int i, float& x, float& y) {
+				y = 0.39f - 0.9f * Wave(i, 400);
+				});
+			measure.Report();
+			work.Report(window);
+		}
+
+		{
+			//Same scrub through the InputQueue, drained once every SamplesPerFrame samples like the main loop
+			Measure measure("queued", &window, icons);
+			Vicetrice::InputQueue input;
+			std::vector<Vicetrice::InputEvent> events;
+			unsigned int dispatched = 0;
+
+			input.PushCursor(PixelX(0.475f), PixelY(0.39f));
+			input.PushButton(GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS);
+			for (unsigned int i = 0; i <= steps; i++)
+			{
+				float y = i < steps ? 0.39f - 0.9f * Wave(i, 400) : 0.39f;
+				input.PushCursor(PixelX(0.475f), PixelY(y));
+				if (i == steps)
+					input.PushButton(GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE);
+				measure.Event();
+
+				if (i % SamplesPerFrame != SamplesPerFrame - 1 && i != steps)
+					continue;
+
+				input.Drain(events);
+				for (const Vicetrice::InputEvent& event : events)
+				{
+					if (event.type == Vicetrice::InputType::CursorPosition)
+					{
+						window.Resize(nullptr, event.x, event.y);
+						window.Move(event.x, event.y);
+					}
+					else if (event.type == Vicetrice::InputType::MouseButton)
+						window.DragON(nullptr, event.button, event.action, event.x, event.y);
+					++dispatched;
+				}
+			}
+			measure.Report();
+			std::cout << "          " << input.Received() << " samples, " << dispatched << " dispatched" << std::endl;
+		}
+
+		{
+			Measure measure("draw", &window, icons);
+			for (unsigned int i = 0; i < steps / 10; i++)
+			{
+				Vicetrice::Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+				window.Draw();
+				measure.Event();
+			}
+			measure.Report();
+		}
+	}
+
+
+	/**
+	 * @brief Draws the same panels as standalone windows and through a WindowManager.
+	 */
+	void RunPanels(unsigned int panels, unsigned int steps)
+	{
+		const unsigned int IconsPerPanel = 20;
+
+		{
+			//Standalone windows build their own GL objects, the programs come from the ShaderCache
+			std::vector<std::unique_ptr<Vicetrice::Window>> windows;
+			Measure create("create", nullptr, panels);
+			for (unsigned int i = 0; i < panels; i++)
+			{
+				windows.push_back(std::make_unique<Vicetrice::Window>(ContextWidth, ContextHeight));
+				create.Event();
+			}
+			create.Report();
+
+			for (unsigned int i = 0; i < panels; i++)
+			{
+				windows[i]->SetPosition(140.0f + 8.0f * static_cast<float>(i % 16), 140.0f + 8.0f * static_cast<float>(i / 16));
+				for (unsigned int j = 0; j < IconsPerPanel; j++)
+					windows[i]->addIcon();
+			}
+
+			Measure measure("panels", nullptr, panels);
+			for (unsigned int i = 0; i < steps / 10; i++)
+			{
+				Vicetrice::Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+				for (std::unique_ptr<Vicetrice::Window>& window : windows)
+					window->Draw();
+				measure.Event();
+			}
+			measure.Report();
+		}
+
+		{
+			Vicetrice::WindowManager manager(ContextWidth, ContextHeight);
+			Vicetrice::Window* top = nullptr;
+			for (unsigned int i = 0; i < panels; i++)
+			{
+				Vicetrice::Window& window = manager.Create();
+				top = &window;
+				window.SetPosition(140.0f + 8.0f * static_cast<float>(i % 16), 140.0f + 8.0f * static_cast<float>(i / 16));
+				for (unsigned int j = 0; j < IconsPerPanel; j++)
+					window.addIcon();
+			}
+
+			//Everything damaged every frame, the rectangles are written again each time
+			Measure measure("batched", nullptr, panels);
+			for (unsigned int i = 0; i < steps / 10; i++)
+			{
+				Vicetrice::Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+				manager.DamageAll();
+				manager.Draw();
+				measure.Event();
+			}
+			measure.Report();
+
+			//Scrub the slider of the top panel, only its rows and thumb are tessellated again
+			double left, up, right, down;
+			top->Bounds(left, up, right, down);
+			float x = static_cast<float>((right - 14.0) / (0.5 * ContextWidth) - 1.0);
+			float y = static_cast<float>(1.0 - (up + 44.0) / (0.5 * ContextHeight));
+
+			Measure scrub("retained", top, panels);
+			WidgetWork work(*top);
+			Drag(*top, scrub, x, y, steps, [y](unsigned int i, float&, float& py) {
+				py = y - 0.4f * Wave(i, 400);
+				});
+			scrub.Report();
+			work.Report(*top);
+		}
+	}
+
+
+	/**
+	 * @brief Encodes a binary PPM, a gradient that differs with each seed, for stb_image to decode like any icon file.
+	 */
+	std::vector<unsigned char> EncodeIcon(unsigned int seed, int width, int height)
+	{
+		std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+		std::vector<unsigned char> file(header.begin(), header.end());
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				file.push_back(static_cast<unsigned char>(255 * x / width));
+				file.push_back(static_cast<unsigned char>(255 * y / height));
+				file.push_back(static_cast<unsigned char>(seed * 53));
+			}
+		}
+
+		return file;
+	}
+
+
+	/**
+	 * @brief Loads distinct icon images into one atlas on the worker of an ImageLoader, then draws panels showing them.
+	 *
+	 * The loading is timed on the render thread only, queueing every image and then pumping the decoded ones
+	 * once per frame. The draws show one image per row, through a WindowManager and a standalone window.
+	 */
+	void RunAtlas(unsigned int images, unsigned int steps)
+	{
+		const int IconImageSize = 32;             // Longest side in the atlas, the 48 pixel images are shrunk to 24
+		const unsigned int UploadsPerFrame = 64;
+		const unsigned int panels = 32;
+		const unsigned int IconsPerPanel = 12;    // About what fits in a panel, every row shown has its own image
+
+		std::vector<std::vector<unsigned char>> files(images);
+		for (unsigned int i = 0; i < images; i++)
+			files[i] = EncodeIcon(i, 16 + 16 * static_cast<int>(i % 3), 16 + 16 * static_cast<int>(i / 3 % 3));
+
+		Vicetrice::TextureAtlas atlas(1024, 64, 4096);
+		std::vector<unsigned int> loaded;
+
+		{
+			Vicetrice::ImageLoader loader(atlas, IconImageSize);
+			auto start = std::chrono::steady_clock::now();
+			std::chrono::steady_clock::duration busy{};
+			unsigned int frames = 0;
+
+			for (std::vector<unsigned char>& file : files)
+				loaded.push_back(loader.Load(std::move(file)));
+			busy += std::chrono::steady_clock::now() - start;
+
+			while (loader.Pending() != 0)
+			{
+				auto pump = std::chrono::steady_clock::now();
+				loader.Pump(UploadsPerFrame);
+				busy += std::chrono::steady_clock::now() - pump;
+				++frames;
+
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+
+			auto total = std::chrono::steady_clock::now() - start;
+			std::cout << "          " << images << " images loaded in " << std::chrono::duration_cast<std::chrono::microseconds>(total).count()
+				<< " us, " << std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count() / images << " ns/image on the render thread over "
+				<< frames << " pumps, " << loader.Failed() << " failed, atlas " << atlas.Width() << "x" << atlas.Height()
+				<< " " << 100 * atlas.Used() / (static_cast<unsigned long long>(atlas.Width()) * atlas.Height()) << "% used" << std::endl;
+		}
+
+		{
+			Vicetrice::WindowManager manager(ContextWidth, ContextHeight);
+			manager.SetAtlas(&atlas);
+			for (unsigned int i = 0; i < panels; i++)
+			{
+				Vicetrice::Window& window = manager.Create();
+				window.SetPosition(8.0f + 24.0f * static_cast<float>(i % 16), 8.0f + 384.0f * static_cast<float>(i / 16));
+				for (unsigned int j = 0; j < IconsPerPanel; j++)
+					window.addIcon(loaded[(i * IconsPerPanel + j) % images]);
+			}
+
+			unsigned long long binds = s_Recorder->Stats().TextureBinds;
+			Measure measure("atlas", nullptr, panels * IconsPerPanel);
+			for (unsigned int i = 0; i < steps / 10; i++)
+			{
+				Vicetrice::Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+				manager.DamageAll();
+				manager.Draw();
+				measure.Event();
+			}
+			measure.Report();
+			std::cout << "          " << static_cast<double>(s_Recorder->Stats().TextureBinds - binds) / (steps / 10) << " texture binds/event" << std::endl;
+		}
+
+		{
+			Vicetrice::Window window(ContextWidth, ContextHeight);
+			window.SetAtlas(&atlas);
+			for (unsigned int j = 0; j < IconsPerPanel; j++)
+				window.addIcon(loaded[j]);
+
+			Measure measure("atlas-win", &window, IconsPerPanel);
+			for (unsigned int i = 0; i < steps / 10; i++)
+			{
+				Vicetrice::Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+				window.Draw();
+				measure.Event();
+			}
+			measure.Report();
+		}
+	}
+
+
+	/**
+	 * @brief Draws panels of labelled rows through a WindowManager, then scrubs a long list of them.
+	 *
+	 * The labels are glyph rectangles of the same batch as the rows: the frames should rasterize and shape
+	 * nothing and keep one draw call, the scrub shapes each label the first time its row shows.
+	 */
+	void RunText(unsigned int panels, unsigned int steps)
+	{
+		const unsigned int IconsPerPanel = 20;
+		const unsigned int TopIcons = 1000;      // Rows of the panel on top, the one scrubbed
+
+		Vicetrice::TextureAtlas atlas(1024, 64, 4096);
+		Vicetrice::Font font(atlas, 16.0f);
+
+		bool loaded = false;
+		for (const char* path : FontPaths)
+			loaded = loaded || font.Load(path);
+		if (!loaded)
+		{
+			std::cout << "          No font found, the text scenarios are skipped" << std::endl;
+			return;
+		}
+
+		Vicetrice::WindowManager manager(ContextWidth, ContextHeight);
+		manager.SetAtlas(&atlas);
+		manager.SetFont(&font);
+
+		//The rows are tessellated as they are added, their labels with them
+		unsigned int rasterized = font.Rasterized();
+		unsigned long long shaped = font.Shaped();
+		Vicetrice::Window* top = nullptr;
+		for (unsigned int i = 0; i < panels; i++)
+		{
+			Vicetrice::Window& window = manager.Create();
+			top = &window;
+			window.SetPosition(140.0f + 8.0f * static_cast<float>(i % 16), 140.0f + 8.0f * static_cast<float>(i / 16));
+
+			unsigned int icons = i + 1 == panels ? TopIcons : IconsPerPanel;
+			for (unsigned int j = 0; j < icons; j++)
+				window.addIcon(Vicetrice::TextureAtlas::NoImage, "Item " + std::to_string(i * IconsPerPanel + j));
+		}
+
+		std::cout << "          " << font.Rasterized() - rasterized << " glyphs rasterized, " << font.Shaped() - shaped
+			<< " labels shaped building the panels" << std::endl;
+
+		//Everything damaged every frame, the labels are copied from the cached rectangles of the rows
+		rasterized = font.Rasterized();
+		shaped = font.Shaped();
+		unsigned long long binds = s_Recorder->Stats().TextureBinds;
+		Measure measure("text", nullptr, panels);
+		for (unsigned int i = 0; i < steps / 10; i++)
+		{
+			Vicetrice::Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+			manager.DamageAll();
+			manager.Draw();
+			measure.Event();
+		}
+		measure.Report();
+		std::cout << "          " << font.Rasterized() - rasterized << " glyphs rasterized, " << font.Shaped() - shaped << " labels shaped, "
+			<< static_cast<double>(s_Recorder->Stats().TextureBinds - binds) / (steps / 10) << " texture binds/event" << std::endl;
+
+		//Scrub the slider of the top panel, a label is shaped the first time its row shows
+		double left, up, right, down;
+		top->Bounds(left, up, right, down);
+		float x = static_cast<float>((right - 14.0) / (0.5 * ContextWidth) - 1.0);
+		float y = static_cast<float>(1.0 - (up + 44.0) / (0.5 * ContextHeight));
+
+		rasterized = font.Rasterized();
+		shaped = font.Shaped();
+		Measure scrub("text-scrub", top, TopIcons);
+		WidgetWork work(*top);
+		Drag(*top, scrub, x, y, steps, [y](unsigned int i, float&, float& py) {
+			py = y - 0.4f * Wave(i, 400);
+			});
+		scrub.Report();
+		work.Report(*top);
+		std::cout << "          " << font.Rasterized() - rasterized << " glyphs rasterized, " << font.Shaped() - shaped << " labels shaped" << std::endl;
+	}
+
+
+	/**
+	 * @brief Generates the instance records of every icon with each SIMD path the CPU runs, ns/event is per icon.
+	 */
+	void RunGenerate(unsigned int icons, unsigned int steps)
+	{
+		std::vector<glm::vec4> colors(icons);
+		std::vector<std::uint32_t> images(icons);
+		for (unsigned int i = 0; i < icons; i++)
+		{
+			colors[i] = glm::vec4(1.0f, Wave(i, 101), 0.0f, 1.0f);
+			images[i] = (i * 37u) % Vicetrice::TextureAtlas::MaxImages;
+		}
+
+		std::vector<Vicetrice::IconInstance> reference(icons);
+		std::vector<Vicetrice::IconInstance> out(icons);
+		Vicetrice::InstanceGenerator::Generate(Vicetrice::SimdPath::Scalar, colors.data(), images.data(), 0, icons, reference.data());
+
+		//About the same number of rows for every size
+		unsigned int repeats = 1 + steps * 500 / icons;
+
+		const Vicetrice::SimdPath paths[] = { Vicetrice::SimdPath::Scalar, Vicetrice::SimdPath::SSE41, Vicetrice::SimdPath::AVX2 };
+		for (Vicetrice::SimdPath path : paths)
+		{
+			if (path > Vicetrice::InstanceGenerator::Supported())
+				break;
+
+			std::string scenario = std::string("gen-") + Vicetrice::InstanceGenerator::Name(path);
+			Measure measure(scenario.c_str(), nullptr, icons);
+			for (unsigned int i = 0; i < repeats; i++)
+			{
+				Vicetrice::InstanceGenerator::Generate(path, colors.data(), images.data(), 0, icons, out.data());
+				measure.Events(icons);
+			}
+			measure.Report();
+
+			if (std::memcmp(out.data(), reference.data(), icons * sizeof(Vicetrice::IconInstance)) != 0)
+				std::cout << "          " << scenario << " differs from the scalar path" << std::endl;
+		}
+	}
+
+
+	/**
+	 * @brief Finds the panel and row under the cursor among many panels, with the HitGrid and by testing each panel.
+	 */
+	void RunHitTest(unsigned int panels, unsigned int steps)
+	{
+		const unsigned int columns = 32;
+		const float spacing = 1.1f;
+
+		//Side by side on a desktop much larger than the context, hit testing is not limited to it
+		Vicetrice::WindowManager manager(ContextWidth, ContextHeight);
+		for (unsigned int i = 0; i < panels; i++)
+		{
+			Vicetrice::Window& window = manager.Create();
+			//Spacing in NDC of the context, the top left corner of the first panel at its default place
+			window.SetPosition(static_cast<float>(PixelX(-0.5f + spacing * static_cast<float>(i % columns))), static_cast<float>(PixelY(0.5f - spacing * static_cast<float>(i / columns))));
+			for (unsigned int j = 0; j < 20; j++)
+				window.addIcon();
+		}
+
+		const float width = spacing * static_cast<float>(columns);
+		const float height = spacing * static_cast<float>((panels + columns - 1) / columns);
+		auto cursor = [&](unsigned int i, double& x, double& y) {
+			x = PixelX(-0.5f + width * Wave(i, 997));
+			y = PixelY(0.5f - height * Wave(i * 7, 1009));
+		};
+
+		//The new panels are indexed on the first query
+		manager.HitTest(0.0, 0.0);
+
+		unsigned int found = 0;
+		{
+			Measure measure("hittest", nullptr, panels);
+			for (unsigned int i = 0; i < steps; i++)
+			{
+				double x, y;
+				cursor(i, x, y);
+				Vicetrice::WindowManager::Hit hit = manager.HitTest(x, y);
+				found += hit.icon != Vicetrice::Window::NoIcon ? 1 : 0;
+				measure.Event();
+			}
+			measure.Report();
+		}
+
+		unsigned int reference = 0;
+		{
+			//What WindowAt did before, every panel tested from the top
+			Measure measure("linear", nullptr, panels);
+			for (unsigned int i = 0; i < steps; i++)
+			{
+				double x, y;
+				cursor(i, x, y);
+				for (std::size_t w = manager.Count(); w-- > 0;)
+				{
+					Vicetrice::Window& window = manager.At(w);
+					if (window.Contains(x, y))
+					{
+						reference += window.IconAt(x, y) != Vicetrice::Window::NoIcon ? 1 : 0;
+						break;
+					}
+				}
+				measure.Event();
+			}
+			measure.Report();
+		}
+
+		std::cout << "          " << found << " rows hit, " << reference << " by testing every panel" << std::endl;
+	}
+
+} // namespace
+
+
+void* operator new(std::size_t size)
+{
+	++s_Allocations;
+	void* ptr = std::malloc(size != 0 ? size : 1);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+
+int main(int argc, char** argv)
+{
+	unsigned int steps = 2000;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--null") == 0)
+			s_Null = true;
+		else
+			steps = static_cast<unsigned int>(std::strtoul(argv[i], nullptr, 10));
+	}
+
+	if (!s_Null && !CreateHeadlessContext())
+		return -1;
+
+	//Only the stats are kept, recording the commands would show up in the allocation counts
+	Vicetrice::RecordingBackend recorder(s_Null ? nullptr : &Vicetrice::Backend::Get(), false);
+	s_Recorder = &recorder;
+	Vicetrice::Backend::Set(&recorder);
+
+	recorder.Enable(GL_BLEND);
+	recorder.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	std::cout << std::left << std::setw(10) << "scenario"
+		<< std::right << std::setw(8) << "icons"
+		<< std::setw(9) << "events"
+		<< std::setw(14) << "ns/event"
+		<< std::setw(14) << "bytes/event"
+		<< std::setw(14) << "uploads/event"
+		<< std::setw(14) << "draws/event"
+		<< std::setw(14) << "allocs/event"
+		<< std::setw(14) << "pixels/event" << std::endl;
+
+	const unsigned int IconCounts[] = { 10, 1000, 100000 };
+	for (unsigned int icons : IconCounts)
+		Run(icons, steps);
+	RunPanels(32, steps);
+	RunHitTest(1024, steps);
+	RunAtlas(500, steps);
+	RunText(32, steps);
+	RunGenerate(1000, steps);
+	RunGenerate(100000, steps);
+
+	Vicetrice::Backend::Set(nullptr);
+	return 0;
+}
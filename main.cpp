@@ -3,6 +3,9 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <string>
+#include <filesystem>
 
 
 #include "VertexArray.hpp"
@@ -10,52 +13,78 @@
 #include "VertexBufferLayout.hpp"
 #include "IndexBuffer.hpp"
 #include "Shader.hpp"
+#include "ShaderCache.hpp"
 #include "vendor/glm/glm.hpp"
 #include "vendor/glm/gtc/matrix_transform.hpp"
 #include "Window.hpp"
+#include "WindowManager.hpp"
 #include "Icon.hpp"
+#include "Profiler.hpp"
+#include "Backend.hpp"
+#include "Error.hpp"
+#include "InputQueue.hpp"
+#include "FrameBuffer.hpp"
+#include "FrameScheduler.hpp"
+#include "CursorCache.hpp"
+#include "TextureAtlas.hpp"
+#include "ImageLoader.hpp"
+#include "Font.hpp"
 
 using namespace Vicetrice;
 
 // Variables globales
 int InicontextWidth = 800;
 int InicontextHeight = 600;
-int Button;
-int Action;
-double Xpos;
-double Ypos;
 
-enum class Events
+// Keep the frame in an offscreen buffer and redraw only the damaged parts of it,
+// otherwise the back buffer is undefined after a swap and every frame is drawn whole
+bool PreserveBackBuffer = true;
+
+// Linked programs are kept here between runs, empty compiles every shader from source at startup
+const char* ShaderBinaryDirectory = "shadercache";
+
+// Every image file here becomes an icon image, decoded while the GUI already runs
+const char* IconDirectory = "res/icons";
+const int IconImageSize = 64;          // Longest side of an icon image in the atlas, larger ones are shrunk
+const unsigned int UploadsPerFrame = 16;
+
+// The labels are drawn with the first of these that loads, no font draws no label
+const char* FontPaths[] =
 {
-	ContextSize,
-	MouseButton,
-	CursorPosition,
+	"res/fonts/Label.ttf",
+	"C:/Windows/Fonts/segoeui.ttf",
+	"/System/Library/Fonts/Supplemental/Arial.ttf",
+	"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf"
 };
+const float LabelPixelHeight = 16.0f;
 
-std::vector<Events> events;
+// Holding UP or DOWN removes or adds an icon this often, in seconds
+const double KeyRepeatInterval = 0.1;
+const unsigned int NoTimer = ~0u;
+
+InputQueue input;
 
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-	events.push_back(Events::ContextSize);
-	InicontextWidth = width;
-	InicontextHeight = height;
-
+	input.PushContextSize(width, height);
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
-	events.push_back(Events::MouseButton);
-	Button = button;
-	Action = action;
+	input.PushButton(button, action);
 }
 
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
 {
-	events.push_back(Events::CursorPosition);
-	Xpos = xpos;
-	Ypos = ypos;
+	input.PushCursor(xpos, ypos);
+}
 
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	// Held keys repeat on a timer of the FrameScheduler, not at the rate of the system
+	if (action != GLFW_REPEAT)
+		input.PushKey(key, action);
 }
 
 int main()
@@ -67,9 +96,13 @@ int main()
 		return -1;
 	}
 
-	glfwWindowHint(GLFW_SAMPLES, 4);
+	// The preserved frame is copied to the window with a blit, which needs a single sampled window
+	glfwWindowHint(GLFW_SAMPLES, PreserveBackBuffer ? 0 : 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+#if VICE_GL_CHECK != VICE_GL_CHECK_OFF
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
 
 	// Crear una ventana y su contexto OpenGL
 	GLFWwindow* window = glfwCreateWindow(InicontextWidth, InicontextHeight, "GUI", NULL, NULL);
@@ -91,81 +124,210 @@ int main()
 
 	std::cout << "Using GL Version: " << glGetString(GL_VERSION) << std::endl;
 
+	VICE_GL_DEBUG_INIT();
+
 	// Registrar la funci�n de callback para el redimensionamiento y el mouse
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 	glfwSetMouseButtonCallback(window, mouse_button_callback);
 	glfwSetCursorPosCallback(window, cursor_position_callback);
+	glfwSetKeyCallback(window, key_callback);
+
+	// Buttons are queued at the last cursor position seen, start from the real one
+	double StartX, StartY;
+	glfwGetCursorPos(window, &StartX, &StartY);
+	input.PushCursor(StartX, StartY);
+
+	ShaderCache::SetBinaryDirectory(ShaderBinaryDirectory);
 
 	{
-		Window Vwindow(InicontextWidth, InicontextHeight);
-		/*Icon icon;
-		icon.AddToContext(Vwindow.Vertices(), Vwindow.Indices(), true, 1);
-		icon.AddToContext(Vwindow.Vertices(), Vwindow.Indices(), true, 2);
-		icon.AddToContext(Vwindow.Vertices(), Vwindow.Indices(), true, 3);
-		icon.AddToContext(Vwindow.Vertices(), Vwindow.Indices(), true, 4);
-		icon.AddToContext(Vwindow.Vertices(), Vwindow.Indices(), true, 5);
-		*/
+		// Overlapping panels, all of them drawn with one draw call
+		WindowManager windows(InicontextWidth, InicontextHeight);
+		const float Positions[][2] = { { 80.0f, 90.0f }, { 200.0f, 150.0f }, { 320.0f, 210.0f } };
+		for (const auto& position : Positions)
+			windows.Create().SetPosition(position[0], position[1]);
+
+		// The loader goes first, its worker never outlives the atlas
+		TextureAtlas atlas(1024, 256, 4096);
+		ImageLoader loader(atlas, IconImageSize);
+		windows.SetAtlas(&atlas);
+
+		// Glyphs go to the same atlas as the images, the labels take no draw call of their own
+		Font font(atlas, LabelPixelHeight);
+		bool FontLoaded = false;
+		for (const char* path : FontPaths)
+			FontLoaded = FontLoaded || font.Load(path);
+		if (FontLoaded)
+			windows.SetFont(&font);
+
+		std::vector<unsigned int> images;
+		std::error_code IconError;
+		for (const auto& entry : std::filesystem::directory_iterator(IconDirectory, IconError))
+		{
+			unsigned int image = entry.is_regular_file() ? loader.Load(entry.path().string()) : TextureAtlas::NoImage;
+			if (image != TextureAtlas::NoImage)
+				images.push_back(image);
+		}
+		std::size_t NextIcon = 0;
+
+		// New icons take the images in turn, flat until theirs is uploaded
+		auto AddIcon = [&]()
+		{
+			unsigned int image = images.empty() ? TextureAtlas::NoImage : images[NextIcon % images.size()];
+			windows.Top().addIcon(image, "Icon " + std::to_string(++NextIcon));
+		};
+
+
+		std::vector<InputEvent> FrameEvents;
+
+		// One frame per refresh of the monitor at most, a swap may not wait for the vsync (hidden window, compositor)
+		double RefreshInterval = 1.0 / 60.0;
+		GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+		const GLFWvidmode* mode = monitor != NULL ? glfwGetVideoMode(monitor) : NULL;
+		if (mode != NULL && mode->refreshRate > 0)
+			RefreshInterval = 1.0 / mode->refreshRate;
+
+		FrameScheduler scheduler(RefreshInterval);
+
+		// Timers of the held UP and DOWN keys
+		unsigned int RemoveTimer = NoTimer;
+		unsigned int AddTimer = NoTimer;
 
+		std::unique_ptr<FrameBuffer> frame;
+		if (PreserveBackBuffer)
+			frame = std::make_unique<FrameBuffer>(InicontextWidth, InicontextHeight);
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		Backend::Get().Enable(GL_BLEND);
+		Backend::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 
 		do
 		{
-			glfwWaitEvents();
-			if (!events.empty()) {
-				Events evnt = events.back();
-				events.pop_back();
+			// Sleeps until there is input, a held key repeats or a requested frame may be rendered
+			scheduler.Wait();
+			VICE_PROFILE_ZONE("Frame");
 
+			// Everything that arrived since the last frame, cursor moves already coalesced
+			input.Drain(FrameEvents);
+			VICE_PROFILE_COUNT(EventsProcessed, FrameEvents.size());
 
-				switch (evnt)
+			for (const InputEvent& evnt : FrameEvents)
+			{
+				switch (evnt.type)
 				{
 
-				case Events::CursorPosition:
-					Vwindow.Resize(window, Xpos, Ypos);
-					Vwindow.Move(Xpos, Ypos);
+				case InputType::CursorPosition:
+					windows.CursorPosition(window, evnt.x, evnt.y);
 
 					break;
-				case Events::MouseButton:
-					Vwindow.DragON(window, Button, Action);
-						
+				case InputType::MouseButton:
+					windows.MouseButton(window, evnt.button, evnt.action, evnt.x, evnt.y);
+
 					break;
-				case Events::ContextSize:
+				case InputType::ContextSize:
+					InicontextWidth = static_cast<int>(evnt.x);
+					InicontextHeight = static_cast<int>(evnt.y);
 
-					Vwindow.AdjustProj(InicontextWidth, InicontextHeight);
+					windows.AdjustProj(InicontextWidth, InicontextHeight);
 
-					glViewport(0, 0, InicontextWidth, InicontextHeight);
+					Backend::Get().Viewport(0, 0, InicontextWidth, InicontextHeight);
+					if (frame)
+						frame->Resize(InicontextWidth, InicontextHeight);
+
+					break;
+				case InputType::Key:
+				{
+					// The keys act on the window on top, once when pressed and then on every period of their timer
+					unsigned int* timer = evnt.button == GLFW_KEY_UP ? &RemoveTimer : evnt.button == GLFW_KEY_DOWN ? &AddTimer : nullptr;
+
+					if (evnt.button == GLFW_KEY_ESCAPE && evnt.action == GLFW_PRESS)
+						glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+					if (timer == nullptr)
+						break;
+
+					if (evnt.action == GLFW_PRESS && *timer == NoTimer)
+					{
+						if (timer == &RemoveTimer)
+							windows.Top().RemoveIcon();
+						else
+							AddIcon();
+						*timer = scheduler.StartTimer(KeyRepeatInterval);
+					}
+					else if (evnt.action == GLFW_RELEASE && *timer != NoTimer)
+					{
+						scheduler.StopTimer(*timer);
+						*timer = NoTimer;
+					}
 
 					break;
+				}
 
 				default:
 					break;
 				}
 			}
 
-			if (glfwGetKey(window,GLFW_KEY_UP) == GLFW_PRESS)
-				Vwindow.RemoveIcon();
-			if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-				Vwindow.addIcon();
-			
-			
+			// A loop that fell behind acts once, not once per missed period
+			if (RemoveTimer != NoTimer && scheduler.Expired(RemoveTimer) != 0)
+				windows.Top().RemoveIcon();
+			if (AddTimer != NoTimer && scheduler.Expired(AddTimer) != 0)
+				AddIcon();
+
+			// A few decoded images per frame, the icons already showing them are drawn again
+			if (loader.Pump(UploadsPerFrame) != 0)
+				windows.DamageAll();
+			if (loader.Pending() != 0)
+				scheduler.RequestFrame();
+
+			if (windows.Rendering())
+				scheduler.RequestFrame();
 
 			// Configurar el shader y los buffers
-			if (Vwindow.Rendering() || Vwindow.Dragging())
+			if (scheduler.FrameDue())
 			{
-				GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+				scheduler.BeginFrame();
 
-				Vwindow.Draw();
+				if (frame)
+				{
+					// Only the damaged rectangles of the preserved frame are cleared and drawn again
+					frame->Bind();
+					Backend::Get().Enable(GL_SCISSOR_TEST);
+					for (const DamageRect& rect : windows.Damage().Rects())
+					{
+						Backend::Get().Scissor(rect.x, rect.y, rect.width, rect.height);
+						Backend::Get().Clear(GL_COLOR_BUFFER_BIT);
+						windows.Draw();
+					}
+					Backend::Get().Disable(GL_SCISSOR_TEST);
+					frame->Present();
+
+					VICE_PROFILE_COUNT(DamagedPixels, windows.Damage().Area());
+				}
+				else
+				{
+					Backend::Get().Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+					windows.Draw();
+
+					VICE_PROFILE_COUNT(DamagedPixels, static_cast<long long>(InicontextWidth) * InicontextHeight);
+				}
+
+				windows.ClearDamage();
 				glfwSwapBuffers(window);
+				scheduler.EndFrame();
 			}
 
+			VICE_GL_CHECK_FRAME();
+			VICE_PROFILE_FRAME();
+
+
 
 
+		} while (glfwWindowShouldClose(window) == 0);
 
-		} while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS &&
-			glfwWindowShouldClose(window) == 0);
+		scheduler.Report(std::cout);
 	}
+	VICE_PROFILE_DUMP("vicegui_trace.json");
+	CursorCache::Clear();
 	glfwTerminate();
 	return 0;
 }
\ No newline at end of file
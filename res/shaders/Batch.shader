@@ -0,0 +1,57 @@
+#shader vertex
+#version 330 core
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec4 i_Rect;
+layout(location = 2) in vec4 i_Color;
+layout(location = 3) in vec4 i_Clip;
+layout(location = 4) in float i_Image;
+
+layout(std140) uniform AtlasBlock
+{
+	vec4 u_Images[1024]; // Left, top, right and bottom of each image of the atlas in texels, empty until it is uploaded
+};
+
+out vec4 OutColor;
+out vec2 OutPosition;
+out vec2 OutTexel;
+flat out vec4 OutClip;
+flat out vec4 OutImage;
+
+void main()
+{
+	// Unit quad stretched over the rectangle (left, bottom, right, top) of the instance, in NDC
+	OutPosition = mix(i_Rect.xy, i_Rect.zw, position.xy);
+	OutColor = i_Color;
+	OutClip = i_Clip;
+	gl_Position = vec4(OutPosition, 0.0, 1.0);
+
+	// Images are stored top row first
+	int image = int(i_Image);
+	OutImage = image != 0 ? u_Images[image] : vec4(0.0);
+	OutTexel = mix(OutImage.xy, OutImage.zw, vec2(position.x, 1.0 - position.y));
+}
+
+
+#shader fragment
+#version 330 core
+layout(location = 0) out vec4 color;
+in vec4 OutColor;
+in vec2 OutPosition;
+in vec2 OutTexel;
+flat in vec4 OutClip;
+flat in vec4 OutImage;
+
+uniform sampler2D u_Atlas;
+
+void main()
+{
+	// Rows are clipped to the panel that owns them
+	vec2 accept = step(OutClip.xy, OutPosition) * step(OutPosition, OutClip.zw);
+
+	// An image is tinted by the color, half a texel inside its rectangle so the filtering never reaches its neighbours in the atlas
+	vec4 base = OutColor;
+	if (OutImage.z > OutImage.x)
+		base *= textureLod(u_Atlas, clamp(OutTexel, OutImage.xy + 0.5, OutImage.zw - 0.5) / vec2(textureSize(u_Atlas, 0)), 0.0);
+
+	color = vec4(base.rgb, base.a * accept.x * accept.y);
+}
@@ -1,17 +1,38 @@
 #shader vertex
 #version 330 core
 layout(location = 0) in vec4 position;
-layout(location = 1) in vec4 m_color;
+layout(location = 1) in int i_Row;
+layout(location = 2) in vec4 i_Color;
+layout(location = 3) in uint i_Image;
 
-uniform mat4 u_M;
+layout(std140) uniform WindowBlock
+{
+	mat4 u_M;
+	vec4 u_WinLimit;
+};
+
+layout(std140) uniform AtlasBlock
+{
+	vec4 u_Images[1024]; // Left, top, right and bottom of each image of the atlas in texels, empty until it is uploaded
+};
+
+uniform float u_FirstRow;
+uniform float u_RowAspect; // Width of the rows over their height
 
 
 out vec4 OutColor;
+out vec2 OutCell;
+flat out vec4 OutImage;
 
 void main()
 {
-	gl_Position = u_M * position;
-	OutColor = m_color; 
+	// Unit quad stacked under the rows above it, u_FirstRow is the scroll and u_M scales the rows to the window
+	gl_Position = u_M * vec4(position.x, position.y - 1.0 - (float(i_Row) - u_FirstRow), 0.0, 1.0);
+	OutColor = i_Color; 
+
+	// The image fills the square at the start of the row: x counts squares from the left, y goes down from the top
+	OutCell = vec2(position.x * u_RowAspect, 1.0 - position.y);
+	OutImage = i_Image != 0u ? u_Images[i_Image] : vec4(0.0);
 }
 
 
@@ -19,8 +40,16 @@ void main()
 #version 330 core
 layout(location = 0) out vec4 color;
 in vec4 OutColor; 
+in vec2 OutCell;
+flat in vec4 OutImage;
+
+layout(std140) uniform WindowBlock
+{
+	mat4 u_M;
+	vec4 u_WinLimit; // Right, left, top and bottom edge of the window, in pixels
+};
 
-uniform vec4 u_WinLimit; 
+uniform sampler2D u_Atlas;
 
 void main()
 {
@@ -30,6 +59,16 @@ void main()
     
     float accept = xAccept * yAccept;
 
+    vec4 base = OutColor;
+    if (OutImage.z > OutImage.x && OutCell.x < 1.0)
+    {
+        // Half a texel inside the image, the filtering never reaches its neighbours in the atlas
+        vec2 texel = clamp(mix(OutImage.xy, OutImage.zw, OutCell), OutImage.xy + 0.5, OutImage.zw - 0.5);
+        vec4 image = textureLod(u_Atlas, texel / vec2(textureSize(u_Atlas, 0)), 0.0);
+
+        // The image over the color of the row
+        base = vec4(mix(base.rgb, image.rgb, image.a), image.a + base.a * (1.0 - image.a));
+    }
     
-    color = vec4(OutColor.rgb, OutColor.a * accept);
+    color = vec4(base.rgb, base.a * accept);
 }
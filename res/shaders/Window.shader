@@ -2,8 +2,13 @@
 #version 330 core
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec4 m_color;
+layout(location = 2) in uint m_VertexID;
 
-uniform mat4 u_M;
+layout(std140) uniform WindowBlock
+{
+    mat4 u_M;
+    vec4 u_WinLimit;
+};
 
 out vec4 OutColor;
 